@@ -0,0 +1,181 @@
+#include "AreaCalculator.h"
+#include "CoordinateCompression.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace 
+{
+    /* Range cover add; the root reports covered length per exact depth */
+    class CoverageSegmentTree 
+    {
+    private:
+        const CoordinateCompression& m_ys;
+        std::vector<int> m_cover;                    /* Rectangles covering the whole node range. */
+        std::vector<std::vector<int64_t>> m_lengths; /* Length per depth within the node, counting only its subtree. */
+
+        void pull(size_t node, size_t lo, size_t hi) 
+        {
+            auto& lengths = m_lengths[node];
+            const int cover = m_cover[node];
+
+            if (hi - lo == 1) 
+            {
+                lengths.assign(cover + 1, 0);
+                lengths[cover] = static_cast<int64_t>(m_ys.value(hi)) - m_ys.value(lo);
+                return;
+            }
+
+            const auto& left = m_lengths[2 * node];
+            const auto& right = m_lengths[2 * node + 1];
+            lengths.assign(cover + std::max(left.size(), right.size()), 0);
+
+            for (size_t d = 0; d < left.size(); ++d) 
+            {
+                lengths[d + cover] += left[d];
+            }
+            for (size_t d = 0; d < right.size(); ++d) 
+            {
+                lengths[d + cover] += right[d];
+            }
+        }
+
+        void build(size_t node, size_t lo, size_t hi) 
+        {
+            if (hi - lo > 1) 
+            {
+                size_t mid = (lo + hi) / 2;
+                build(2 * node, lo, mid);
+                build(2 * node + 1, mid, hi);
+            }
+            pull(node, lo, hi);
+        }
+
+        void add(size_t node, size_t lo, size_t hi, size_t begin, size_t end, int delta) 
+        {
+            if (end <= lo || hi <= begin) 
+            {
+                return;
+            }
+
+            if (begin <= lo && hi <= end) 
+            {
+                m_cover[node] += delta;
+            }
+            else 
+            {
+                size_t mid = (lo + hi) / 2;
+                add(2 * node, lo, mid, begin, end, delta);
+                add(2 * node + 1, mid, hi, begin, end, delta);
+            }
+            pull(node, lo, hi);
+        }
+
+    public:
+        explicit CoverageSegmentTree(const CoordinateCompression& ys): 
+            m_ys(ys), m_cover(4 * ys.size(), 0), m_lengths(4 * ys.size()) 
+        {
+            build(1, 0, m_ys.size() - 1);
+        }
+
+        /* Adds delta to the cover count of the elementary intervals [begin, end) */
+        void add(size_t begin, size_t end, int delta) 
+        {
+            add(1, 0, m_ys.size() - 1, begin, end, delta);
+        }
+
+        /* Covered length per exact depth over the whole y range */
+        const std::vector<int64_t>& lengths() const 
+        {
+            return m_lengths[1];
+        }
+    };
+
+    /* An x edge; all edges at one x are applied before the next slab is measured */
+    struct Event 
+    {
+        int x;
+        int delta;
+        size_t index;
+
+        bool operator<(const Event& other) const 
+        {
+            return x < other.x;
+        }
+    };
+}
+
+AreaStats AreaCalculator::computeAreaStats(const std::vector<Rectangle>& rectangles) 
+{
+    AreaStats stats;
+
+    if (rectangles.empty()) 
+    {
+        return stats;
+    }
+
+    std::vector<int> y_values;
+    std::vector<Event> events;
+    y_values.reserve(rectangles.size() * 2);
+    events.reserve(rectangles.size() * 2);
+
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        y_values.push_back(rectangles[i].y());
+        y_values.push_back(rectangles[i].bottom());
+        events.push_back({rectangles[i].x(), 1, i});
+        events.push_back({rectangles[i].right(), -1, i});
+    }
+
+    const CoordinateCompression ys(std::move(y_values));
+    std::sort(events.begin(), events.end());
+
+    std::vector<size_t> top_index(rectangles.size());
+    std::vector<size_t> bottom_index(rectangles.size());
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        top_index[i] = ys.indexOf(rectangles[i].y());
+        bottom_index[i] = ys.indexOf(rectangles[i].bottom());
+    }
+
+    CoverageSegmentTree tree(ys);
+
+    for (size_t e = 0; e < events.size(); ) 
+    {
+        const int x = events[e].x;
+        for (; e < events.size() && events[e].x == x; ++e) 
+        {
+            tree.add(top_index[events[e].index], bottom_index[events[e].index], events[e].delta);
+        }
+
+        if (e == events.size()) 
+        {
+            break;
+        }
+
+        /* The slab [x, next x) has constant coverage along y */
+        const int64_t width = static_cast<int64_t>(events[e].x) - x;
+        const auto& lengths = tree.lengths();
+
+        if (stats.area_by_depth.size() < lengths.size()) 
+        {
+            stats.area_by_depth.resize(lengths.size(), 0);
+        }
+        for (size_t d = 1; d < lengths.size(); ++d) 
+        {
+            stats.area_by_depth[d] += lengths[d] * width;
+        }
+    }
+
+    while (!stats.area_by_depth.empty() && stats.area_by_depth.back() == 0) 
+    {
+        stats.area_by_depth.pop_back();
+    }
+
+    for (size_t d = 1; d < stats.area_by_depth.size(); ++d) 
+    {
+        stats.union_area += stats.area_by_depth[d];
+    }
+
+    return stats;
+}
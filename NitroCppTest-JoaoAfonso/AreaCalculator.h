@@ -0,0 +1,42 @@
+#ifndef AREA_CALCULATOR_HPP
+#define AREA_CALCULATOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Rectangle.h"
+
+/**
+* @struct AreaStats
+* @brief Covered area of a rectangle set, in total and split by coverage depth.
+*/
+struct AreaStats 
+{
+    int64_t union_area = 0;              /* Area covered by at least one rectangle */
+    std::vector<int64_t> area_by_depth;  /* Entry k: area covered by exactly k rectangles (entry 0 unused) */
+};
+
+/**
+* @class AreaCalculator
+* @brief Computes union area and exact-depth areas with a sweep over a coverage segment tree.
+*
+* Each segment tree node over the compressed y intervals stores how many rectangles cover
+* its whole range and, for every depth d, the length of its range covered exactly d times by
+* the rectangles stored in its subtree. The root therefore describes the current slab, and
+* each x slab contributes length * width per depth. Updates cost O(D log n), where D is the
+* maximum overlap depth. All sums use 64-bit integers.
+*/
+class AreaCalculator 
+{
+public:
+    /**
+    * @brief Computes the area statistics of a set of rectangles.
+    *
+    * Results are exact as long as the areas fit in a signed 64-bit integer.
+    *
+    * @param rectangles Input rectangles (positive width and height).
+    * @return AreaStats Union area and the per-depth areas; area_by_depth ends at the maximum depth.
+    */
+    static AreaStats computeAreaStats(const std::vector<Rectangle>& rectangles);
+};
+
+#endif // AREA_CALCULATOR_HPP
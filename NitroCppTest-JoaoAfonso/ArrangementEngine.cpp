@@ -0,0 +1,159 @@
+#include "ArrangementEngine.h"
+#include "CoordinateCompression.h"
+
+#include <algorithm>
+
+namespace 
+{
+    /* A run of elementary y intervals sharing one coverage set, possibly spanning several slabs */
+    struct OpenCell 
+    {
+        int x;
+        size_t y_begin;
+        size_t y_end;
+        std::vector<int> ids;
+    };
+}
+
+std::vector<IntersectionResult> ArrangementEngine::buildCells(const std::vector<Rectangle>& rectangles, std::pmr::memory_resource* resource) 
+{
+    std::vector<IntersectionResult> cells;
+    std::vector<int> x_values;
+    std::vector<int> y_values;
+
+    for (const auto& rect : rectangles) 
+    {
+        x_values.push_back(rect.x());
+        x_values.push_back(rect.right());
+        y_values.push_back(rect.y());
+        y_values.push_back(rect.bottom());
+    }
+
+    const CoordinateCompression xs(std::move(x_values));
+    const CoordinateCompression ys(std::move(y_values));
+
+    if (xs.size() < 2 || ys.size() < 2) 
+    {
+        return cells;
+    }
+
+    /* Rectangles starting and ending at each compressed x, in input order */
+    std::vector<std::vector<size_t>> starts(xs.size());
+    std::vector<std::vector<size_t>> ends(xs.size());
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        starts[xs.indexOf(rectangles[i].x())].push_back(i);
+        ends[xs.indexOf(rectangles[i].right())].push_back(i);
+    }
+
+    /* Active rectangles ordered by ID (then index), so the coverage lists come out sorted by ID whatever the input order */
+    std::vector<size_t> active;
+    auto by_id = [&rectangles](size_t a, size_t b) 
+    {
+        if (rectangles[a].id() != rectangles[b].id()) 
+        {
+            return rectangles[a].id() < rectangles[b].id();
+        }
+        return a < b;
+    };
+    std::vector<OpenCell> open_cells;
+    std::vector<std::vector<int>> coverage(ys.size() - 1);
+
+    auto close_cell = [&](const OpenCell& cell, int x_end) 
+    {
+        int y = ys.value(cell.y_begin);
+        Rectangle rect(-1, cell.x, y, x_end - cell.x, ys.value(cell.y_end) - y);
+        cells.push_back({rect, std::pmr::vector<int>(cell.ids.begin(), cell.ids.end(), resource)});
+    };
+
+    for (size_t xi = 0; xi + 1 < xs.size(); ++xi) 
+    {
+        /* Update the active set for the slab [xs[xi], xs[xi + 1]) */
+        for (size_t index : ends[xi]) 
+        {
+            active.erase(std::find(active.begin(), active.end(), index));
+        }
+        for (size_t index : starts[xi]) 
+        {
+            active.insert(std::lower_bound(active.begin(), active.end(), index, by_id), index);
+        }
+
+        for (auto& ids : coverage) 
+        {
+            ids.clear();
+        }
+
+        /* Active is ordered by ID, which keeps each coverage list sorted */
+        for (size_t index : active) 
+        {
+            const auto& rect = rectangles[index];
+            for (size_t yi = ys.indexOf(rect.y()); yi < ys.indexOf(rect.bottom()); ++yi) 
+            {
+                coverage[yi].push_back(rect.id());
+            }
+        }
+
+        /* Merge consecutive elementary intervals with the same coverage into runs */
+        std::vector<OpenCell> runs;
+        for (size_t yi = 0; yi < coverage.size(); ++yi) 
+        {
+            if (coverage[yi].empty()) 
+            {
+                continue;
+            }
+
+            if (!runs.empty() && runs.back().y_end == yi && runs.back().ids == coverage[yi]) 
+            {
+                runs.back().y_end = yi + 1;
+            }
+            else 
+            {
+                runs.push_back({xs.value(xi), yi, yi + 1, coverage[yi]});
+            }
+        }
+
+        /* Extend cells from the previous slab that continue unchanged, close the others */
+        std::vector<OpenCell> next_open;
+        size_t previous = 0;
+        for (auto& run : runs) 
+        {
+            while (previous < open_cells.size() && open_cells[previous].y_begin < run.y_begin) 
+            {
+                close_cell(open_cells[previous++], xs.value(xi));
+            }
+
+            if (previous < open_cells.size() &&
+                open_cells[previous].y_begin == run.y_begin &&
+                open_cells[previous].y_end == run.y_end &&
+                open_cells[previous].ids == run.ids) 
+            {
+                next_open.push_back(std::move(open_cells[previous++]));
+            }
+            else 
+            {
+                next_open.push_back(std::move(run));
+            }
+        }
+        while (previous < open_cells.size()) 
+        {
+            close_cell(open_cells[previous++], xs.value(xi));
+        }
+
+        open_cells = std::move(next_open);
+    }
+
+    for (const auto& cell : open_cells) 
+    {
+        close_cell(cell, xs.value(xs.size() - 1));
+    }
+
+    std::sort(cells.begin(), cells.end(), [](const IntersectionResult& a, const IntersectionResult& b) {
+        if (a.rect.x() != b.rect.x()) 
+        {
+            return a.rect.x() < b.rect.x();
+        }
+        return a.rect.y() < b.rect.y();
+    });
+
+    return cells;
+}
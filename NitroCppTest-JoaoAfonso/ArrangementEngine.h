@@ -0,0 +1,36 @@
+#ifndef ARRANGEMENT_ENGINE_HPP
+#define ARRANGEMENT_ENGINE_HPP
+
+#include <vector>
+#include "Rectangle.h"
+#include "IntersectionFinder.h"
+
+/**
+* @class ArrangementEngine
+* @brief Decomposes the covered part of the plane into disjoint cells labelled by coverage.
+*
+* Rectangle edges are compressed into a grid of at most (2n - 1)^2 elementary cells. A sweep
+* over the x slabs assigns every elementary cell the set of rectangles covering it, and
+* neighbouring cells with the same coverage set are merged (vertically within a slab and
+* horizontally across slabs). The number of cells is therefore O(n^2) no matter how many
+* rectangles are stacked on top of each other.
+*/
+class ArrangementEngine 
+{
+public:
+    /**
+    * @brief Builds the arrangement cells of a set of rectangles.
+    *
+    * Each result holds a cell in 'rect' and the IDs of every rectangle covering it, sorted
+    * ascending, in 'parent_ids'. Cells are disjoint and together cover exactly the union of
+    * the input. Uncovered regions are not reported.
+    *
+    * @param rectangles Input rectangles (positive width and height).
+    * @param resource Memory resource of the cells' ID lists.
+    * @return std::vector<IntersectionResult> The cells, ordered by their left edge then top edge.
+    */
+    static std::vector<IntersectionResult> buildCells(const std::vector<Rectangle>& rectangles,
+                                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+};
+
+#endif // ARRANGEMENT_ENGINE_HPP
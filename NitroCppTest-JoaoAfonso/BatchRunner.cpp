@@ -0,0 +1,258 @@
+#include "BatchRunner.h"
+#include "OrderCounter.h"
+#include "TraceRecorder.h"
+
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+void BatchRunner::runScene(IntersectionFinder& finder, const BatchOptions& options, std::istream& input, std::ostream& out) 
+{
+    finder.loadRectanglesFromStream(input, inputLimit(options), out);
+    processScene(finder, options, out);
+}
+
+size_t BatchRunner::inputLimit(const BatchOptions& options) 
+{
+    const std::string& mode = options.mode;
+
+    /* Counting never materializes results, so the input limit does not apply */
+    if (mode == "--count-pairs" || mode == "--count-orders" || mode == "--max-depth" || mode == "--area") 
+    {
+        return 0;
+    }
+    return MAX_RECTANGLES;
+}
+
+void BatchRunner::processScene(IntersectionFinder& finder, const BatchOptions& options, std::ostream& out) 
+{
+    const std::string& mode = options.mode;
+
+    if (mode == "--count-pairs") 
+    {
+        out << "Overlapping pairs: " << finder.countOverlappingPairs() << "\n";
+        return;
+    }
+
+    if (mode == "--count-orders") 
+    {
+        auto counts = finder.countIntersectionsByOrder();
+
+        out << "Intersections by number of rectangles:\n";
+        for (size_t k = 2; k < counts.size(); ++k) 
+        {
+            out << "\t" << k << ": " << counts[k].toString() << "\n";
+        }
+        out << "Total: " << OrderCounter::totalIntersections(counts).toString() << "\n";
+        return;
+    }
+
+    if (mode == "--max-depth") 
+    {
+        IntersectionResult deepest = finder.findMaxDepth();
+
+        out << "Maximum depth: " << deepest.parent_ids.size() << "\n";
+        IntersectionFinder::printResult(out, deepest);
+        return;
+    }
+
+    if (mode == "--area") 
+    {
+        AreaStats stats = finder.computeAreaStats();
+
+        out << "Union area: " << stats.union_area << "\n";
+        out << "Area covered by exactly k rectangles:\n";
+        for (size_t k = 1; k < stats.area_by_depth.size(); ++k) 
+        {
+            out << "\t" << k << ": " << stats.area_by_depth[k] << "\n";
+        }
+        return;
+    }
+
+    if (options.limit_results) 
+    {
+        /* Predict the output size and refuse runaway jobs before enumerating */
+        BigUnsigned limit(options.max_results);
+        BigUnsigned predicted = OrderCounter::totalIntersections(finder.countIntersectionsByOrder());
+        if (predicted > limit) 
+        {
+            throw std::runtime_error("Refusing to enumerate " + predicted.toString() +
+                                     " intersections (limit " + limit.toString() + ").");
+        }
+    }
+
+    std::vector<IntersectionResult> cached;
+    if (options.cache != nullptr && options.cache->lookup(mode, finder.rectangles(), cached)) 
+    {
+        finder.restoreIntersections(std::move(cached));
+    }
+    else 
+    {
+        if (mode == "--maximal") 
+        {
+            finder.processMaximalIntersections();
+        }
+        else if (mode == "--cells") 
+        {
+            finder.processArrangementCells();
+        }
+        else 
+        {
+            finder.processIntersections();
+        }
+
+        if (options.cache != nullptr) 
+        {
+            options.cache->store(mode, finder.rectangles(), finder.intersections());
+        }
+    }
+
+    finder.printResults(out);
+}
+
+std::vector<BatchScene> BatchRunner::listScenes(const std::string& source) 
+{
+    namespace fs = std::filesystem;
+    std::vector<BatchScene> scenes;
+    std::error_code error;
+
+    if (fs::is_directory(source, error)) 
+    {
+        for (const auto& entry : fs::directory_iterator(source, error)) 
+        {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".json") 
+            {
+                scenes.push_back({entry.path().string(), std::string()});
+            }
+        }
+        if (error) 
+        {
+            throw std::runtime_error("Could not read directory: " + source);
+        }
+
+        std::sort(scenes.begin(), scenes.end(), [](const BatchScene& a, const BatchScene& b) { return a.name < b.name; });
+        return scenes;
+    }
+
+    std::ifstream list(source);
+    if (!list.is_open()) 
+    {
+        throw std::runtime_error("Could not open file: " + source);
+    }
+
+    std::string extension = fs::path(source).extension().string();
+    if (extension == ".ndjson" || extension == ".jsonl") 
+    {
+        return readNdjson(list);
+    }
+
+    std::string line;
+    while (std::getline(list, line)) 
+    {
+        if (!line.empty() && line.back() == '\r') 
+        {
+            line.pop_back();
+        }
+        if (!line.empty()) 
+        {
+            scenes.push_back({line, std::string()});
+        }
+    }
+    return scenes;
+}
+
+std::vector<BatchScene> BatchRunner::readNdjson(std::istream& input) 
+{
+    std::vector<BatchScene> scenes;
+    std::string line;
+    size_t line_number = 0;
+
+    while (std::getline(input, line)) 
+    {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") != std::string::npos) 
+        {
+            scenes.push_back({"line " + std::to_string(line_number), std::move(line)});
+            line = std::string();
+        }
+    }
+    return scenes;
+}
+
+size_t BatchRunner::run(const std::vector<BatchScene>& scenes, const BatchOptions& options, ThreadPool& pool, std::ostream& out) 
+{
+    std::unique_ptr<SceneWorker[]> workers(new SceneWorker[pool.size()]);
+    const size_t window = BATCH_WINDOW_PER_WORKER * pool.size();
+    /* Ring of the outputs in the window, slot index % window */
+    std::vector<std::string> outputs(window);
+    std::vector<char> finished(window, 0);
+    size_t next_output = 0;
+    std::atomic<size_t> failed{0};
+    std::mutex output_mutex;
+    std::condition_variable window_moved;
+
+    pool.parallelFor(scenes.size(), [&](size_t index, size_t worker) { 
+        {
+            /* Indices are handed out in order, so the scene at next_output is always running and never waits here */
+            std::unique_lock<std::mutex> lock(output_mutex);
+            window_moved.wait(lock, [&]() { return index < next_output + window; });
+        }
+
+        const BatchScene& scene = scenes[index];
+        std::ostringstream text;
+        text << "Scene " << scene.name << ":\n";
+
+        try 
+        {
+            TRACE_SCOPE("scene");
+            SceneWorker& current = workers[worker];
+            current.beginScene();
+            if (scene.json.empty()) 
+            {
+                std::ifstream file(scene.name);
+                if (!file.is_open()) 
+                {
+                    throw std::runtime_error("Could not open file: " + scene.name);
+                }
+                runScene(current.finder, options, file, text);
+            }
+            else 
+            {
+                std::istringstream document(scene.json);
+                runScene(current.finder, options, document, text);
+            }
+        } 
+        catch (const std::exception& e) 
+        {
+            text << "Error: " << e.what() << "\n";
+            ++failed;
+        }
+
+        /* Flush the longest finished prefix so outputs leave in input order */
+        std::lock_guard<std::mutex> lock(output_mutex);
+        TRACE_SCOPE("merge");
+        outputs[index % window] = text.str();
+        finished[index % window] = 1;
+        const size_t written = next_output;
+        while (next_output < scenes.size() && finished[next_output % window]) 
+        {
+            out << outputs[next_output % window];
+            std::string().swap(outputs[next_output % window]);
+            finished[next_output % window] = 0;
+            ++next_output;
+        }
+        if (next_output != written) 
+        {
+            window_moved.notify_all();
+        }
+    });
+
+    out.flush();
+    return failed;
+}
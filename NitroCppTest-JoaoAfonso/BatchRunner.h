@@ -0,0 +1,137 @@
+#ifndef BATCH_RUNNER_HPP
+#define BATCH_RUNNER_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <memory_resource>
+#include "IntersectionFinder.h"
+#include "ThreadPool.h"
+#include "ResultCache.h"
+
+/* Scenes each worker may run ahead of the oldest unwritten output */
+#define BATCH_WINDOW_PER_WORKER 4u
+
+/**
+* @struct BatchOptions
+* @brief What to compute for every scene.
+*/
+struct BatchOptions 
+{
+    std::string mode;              /* Mode flag as accepted by main (e.g. "--maximal"); empty enumerates every intersection */
+    bool limit_results = false;    /* True to refuse scenes predicted to have more than max_results intersections */
+    uint64_t max_results = 0;      /* Limit applied when limit_results is set */
+    ResultCache* cache = nullptr;  /* Replays enumeration results of repeated scenes when set */
+};
+
+/**
+* @struct BatchScene
+* @brief One scene of a batch: a JSON file, or a JSON document taken from an NDJSON stream.
+*/
+struct BatchScene 
+{
+    std::string name;  /* File path, or "line N" for NDJSON input */
+    std::string json;  /* Inline JSON document; empty when the scene is read from the file called name */
+};
+
+/**
+* @struct SceneWorker
+* @brief The finder a batch or pipeline worker reuses for every scene it takes, with a
+* monotonic arena holding the results of the current scene.
+*/
+struct SceneWorker 
+{
+    std::pmr::monotonic_buffer_resource arena;  /* IDs of the current scene's results */
+    IntersectionFinder finder{&arena};
+
+    /**
+    * @brief Drops the previous scene's results and releases the arena in one step, instead of
+    * freeing one ID vector per result.
+    */
+    void beginScene() 
+    {
+        finder.clearResults();
+        arena.release();
+    }
+};
+
+/**
+* @class BatchRunner
+* @brief Processes many scenes in one process on a shared thread pool.
+*
+* Every worker owns one SceneWorker and reuses its finder, with its already grown
+* buffers, for each scene it picks up. Outputs are buffered per scene and written in
+* input order as soon as every earlier scene is done. A worker does not start a scene
+* more than BATCH_WINDOW_PER_WORKER x workers scenes past the oldest unwritten output,
+* so one slow scene bounds the buffered outputs by that window, not by the batch size.
+* The scene list itself is held in memory: NDJSON documents are read up front, while
+* directory and list scenes are opened only when they run.
+*/
+class BatchRunner 
+{
+public:
+    /**
+    * @brief Loads one scene, computes the selected mode and prints its output.
+    *
+    * Produces exactly what the single-file command line prints for the same mode.
+    *
+    * @param finder Finder to load the scene into; its previous contents are discarded.
+    * @param options Mode and result limit.
+    * @param input Stream positioned at the JSON document.
+    * @param out Receives the output and any informational loader messages.
+    * @throws std::runtime_error on invalid input or when the result limit is exceeded.
+    */
+    static void runScene(IntersectionFinder& finder, const BatchOptions& options, std::istream& input, std::ostream& out);
+
+    /**
+    * @brief Returns how many rectangles a scene may load for the selected mode.
+    * @return MAX_RECTANGLES for the enumerating modes, 0 (no limit) for the analytic ones.
+    */
+    static size_t inputLimit(const BatchOptions& options);
+
+    /**
+    * @brief Computes the selected mode on a loaded scene and prints its output.
+    * @param finder Finder holding the scene.
+    * @param options Mode and result limit.
+    * @param out Receives the output.
+    * @throws std::runtime_error when the result limit is exceeded.
+    */
+    static void processScene(IntersectionFinder& finder, const BatchOptions& options, std::ostream& out);
+
+    /**
+    * @brief Expands a batch source into its scenes.
+    *
+    * - A directory yields its *.json files, sorted by name.
+    * - A file ending in .ndjson or .jsonl yields one scene per non-empty line.
+    * - Any other file is a list of scene file paths, one per line.
+    *
+    * @param source Directory, NDJSON file or list file.
+    * @return The scenes, in input order.
+    * @throws std::runtime_error if the source cannot be read.
+    */
+    static std::vector<BatchScene> listScenes(const std::string& source);
+
+    /**
+    * @brief Reads one scene per non-empty line of an NDJSON stream.
+    * @param input The stream.
+    * @return The scenes, named after their line numbers.
+    */
+    static std::vector<BatchScene> readNdjson(std::istream& input);
+
+    /**
+    * @brief Processes scenes concurrently and writes their outputs in input order.
+    *
+    * A scene that fails is reported in its own output block; the other scenes still run.
+    *
+    * @param scenes Scenes to process.
+    * @param options Mode and result limit.
+    * @param pool Pool running the scenes.
+    * @param out Destination of the outputs, each preceded by a "Scene <name>:" header.
+    * @return Number of scenes that failed.
+    */
+    static size_t run(const std::vector<BatchScene>& scenes, const BatchOptions& options, ThreadPool& pool, std::ostream& out);
+};
+
+#endif // BATCH_RUNNER_HPP
@@ -0,0 +1,174 @@
+#include "BigUnsigned.h"
+
+#include <algorithm>
+
+BigUnsigned::BigUnsigned(uint64_t value) 
+{
+    while (value != 0) 
+    {
+        m_limbs.push_back(static_cast<uint32_t>(value));
+        value >>= 32;
+    }
+}
+
+void BigUnsigned::trim() 
+{
+    while (!m_limbs.empty() && m_limbs.back() == 0) 
+    {
+        m_limbs.pop_back();
+    }
+}
+
+BigUnsigned& BigUnsigned::operator+=(const BigUnsigned& other) 
+{
+    if (m_limbs.size() < other.m_limbs.size()) 
+    {
+        m_limbs.resize(other.m_limbs.size(), 0);
+    }
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < m_limbs.size(); ++i) 
+    {
+        uint64_t sum = carry + m_limbs[i] + (i < other.m_limbs.size() ? other.m_limbs[i] : 0);
+        m_limbs[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+
+        /* Past the other operand only the carry can still change digits */
+        if (carry == 0 && i >= other.m_limbs.size()) 
+        {
+            break;
+        }
+    }
+
+    if (carry != 0) 
+    {
+        m_limbs.push_back(static_cast<uint32_t>(carry));
+    }
+
+    return *this;
+}
+
+BigUnsigned BigUnsigned::operator+(const BigUnsigned& other) const 
+{
+    BigUnsigned result = *this;
+    result += other;
+    return result;
+}
+
+BigUnsigned BigUnsigned::operator*(const BigUnsigned& other) const 
+{
+    BigUnsigned result;
+    if (isZero() || other.isZero()) 
+    {
+        return result;
+    }
+
+    result.m_limbs.assign(m_limbs.size() + other.m_limbs.size(), 0);
+
+    /* Schoolbook multiplication; each partial product fits in 64 bits with its carry */
+    for (size_t i = 0; i < m_limbs.size(); ++i) 
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < other.m_limbs.size(); ++j) 
+        {
+            uint64_t current = static_cast<uint64_t>(m_limbs[i]) * other.m_limbs[j] + result.m_limbs[i + j] + carry;
+            result.m_limbs[i + j] = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+        result.m_limbs[i + other.m_limbs.size()] = static_cast<uint32_t>(carry);
+    }
+
+    result.trim();
+    return result;
+}
+
+bool BigUnsigned::operator==(const BigUnsigned& other) const 
+{
+    return m_limbs == other.m_limbs;
+}
+
+bool BigUnsigned::operator!=(const BigUnsigned& other) const 
+{
+    return !(*this == other);
+}
+
+bool BigUnsigned::operator<(const BigUnsigned& other) const 
+{
+    if (m_limbs.size() != other.m_limbs.size()) 
+    {
+        return m_limbs.size() < other.m_limbs.size();
+    }
+
+    return std::lexicographical_compare(m_limbs.rbegin(), m_limbs.rend(), other.m_limbs.rbegin(), other.m_limbs.rend());
+}
+
+bool BigUnsigned::operator>(const BigUnsigned& other) const 
+{
+    return other < *this;
+}
+
+bool BigUnsigned::operator<=(const BigUnsigned& other) const 
+{
+    return !(other < *this);
+}
+
+bool BigUnsigned::operator>=(const BigUnsigned& other) const 
+{
+    return !(*this < other);
+}
+
+bool BigUnsigned::toUint64(uint64_t& value) const 
+{
+    bool boReturn = false;
+
+    if (m_limbs.size() <= 2) 
+    {
+        value = 0;
+        for (size_t i = m_limbs.size(); i > 0; --i) 
+        {
+            value = (value << 32) | m_limbs[i - 1];
+        }
+        boReturn = true;
+    }
+
+    return boReturn;
+}
+
+std::string BigUnsigned::toString() const 
+{
+    if (isZero()) 
+    {
+        return "0";
+    }
+
+    /* Repeatedly divide by 10^9 and collect the remainders as 9-digit chunks */
+    std::vector<uint32_t> quotient = m_limbs;
+    std::vector<uint32_t> chunks;
+    const uint32_t chunk_base = 1000000000;
+
+    while (!quotient.empty()) 
+    {
+        uint64_t remainder = 0;
+        for (size_t i = quotient.size(); i > 0; --i) 
+        {
+            uint64_t current = (remainder << 32) | quotient[i - 1];
+            quotient[i - 1] = static_cast<uint32_t>(current / chunk_base);
+            remainder = current % chunk_base;
+        }
+        chunks.push_back(static_cast<uint32_t>(remainder));
+
+        while (!quotient.empty() && quotient.back() == 0) 
+        {
+            quotient.pop_back();
+        }
+    }
+
+    std::string text = std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i > 0; --i) 
+    {
+        std::string digits = std::to_string(chunks[i - 1]);
+        text += std::string(9 - digits.size(), '0') + digits;
+    }
+
+    return text;
+}
@@ -0,0 +1,57 @@
+#ifndef BIG_UNSIGNED_HPP
+#define BIG_UNSIGNED_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+* @class BigUnsigned
+* @brief Arbitrary-precision non-negative integer.
+*
+* Used for exact intersection counts, which grow like 2^n and overflow 64 bits on
+* scenes with more than 64 mutually overlapping rectangles. Only the operations the
+* counting code needs are provided: addition, multiplication, comparison and printing.
+*/
+class BigUnsigned 
+{
+private:
+    std::vector<uint32_t> m_limbs;  /* Base 2^32 digits, least significant first, without leading zeros. */
+
+    void trim();
+
+public:
+    /**
+    * @brief Constructs a number from a 64-bit value (0 by default).
+    * @param value Initial value.
+    */
+    BigUnsigned(uint64_t value = 0);
+
+    inline bool isZero() const { return m_limbs.empty(); }  /* Returns true if the value is 0. */
+
+    BigUnsigned& operator+=(const BigUnsigned& other);
+    BigUnsigned operator+(const BigUnsigned& other) const;
+    BigUnsigned operator*(const BigUnsigned& other) const;
+
+    bool operator==(const BigUnsigned& other) const;
+    bool operator!=(const BigUnsigned& other) const;
+    bool operator<(const BigUnsigned& other) const;
+    bool operator>(const BigUnsigned& other) const;
+    bool operator<=(const BigUnsigned& other) const;
+    bool operator>=(const BigUnsigned& other) const;
+
+    /**
+    * @brief Converts to a 64-bit integer when the value fits.
+    * @param value Receives the value on success.
+    * @return true if the value fits in 64 bits; false otherwise (value is left unchanged).
+    */
+    bool toUint64(uint64_t& value) const;
+
+    /**
+    * @brief Formats the value in decimal.
+    * @return std::string Decimal digits without leading zeros ("0" for zero).
+    */
+    std::string toString() const;
+};
+
+#endif // BIG_UNSIGNED_HPP
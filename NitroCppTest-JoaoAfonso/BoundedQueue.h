@@ -0,0 +1,287 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+/* Assumed size of a cache line; producer and consumer indices are kept on separate lines */
+#define QUEUE_CACHE_LINE 64
+
+/* Failed attempts a waiting thread spins, then yields, before it starts sleeping */
+#define QUEUE_SPIN_ATTEMPTS 64u
+#define QUEUE_YIELD_ATTEMPTS 128u
+
+/* Longest sleep between two attempts of a waiting thread, in microseconds */
+#define QUEUE_MAX_SLEEP_US 200u
+
+namespace queue_detail 
+{
+    /**
+    * @brief Rounds a capacity up to a power of two (at least 2) so indices can be masked.
+    */
+    inline size_t roundCapacity(size_t capacity) 
+    {
+        size_t rounded = 2;
+        while (rounded < capacity) 
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    /**
+    * @brief Waits between failed queue operations: spins briefly, then yields the core, then
+    * sleeps for doubling periods up to QUEUE_MAX_SLEEP_US so an idle stage gives its core back.
+    * @param attempts Failed attempts so far; reset it to 0 once the operation succeeds.
+    */
+    inline void backoff(unsigned& attempts) 
+    {
+        ++attempts;
+        if (attempts <= QUEUE_SPIN_ATTEMPTS) 
+        {
+            return;
+        }
+        if (attempts <= QUEUE_YIELD_ATTEMPTS) 
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        const unsigned doublings = std::min(attempts - QUEUE_YIELD_ATTEMPTS, 8u);
+        const unsigned sleep_us = std::min(1u << doublings, QUEUE_MAX_SLEEP_US);
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+    }
+}
+
+/**
+* @class SpscQueue
+* @brief Lock-free bounded queue for exactly one producer and one consumer thread.
+*
+* A ring buffer with acquire/release indices. Each side caches the other side's index and
+* only reloads it when the ring looks full or empty, so the shared cache lines are touched
+* once per batch rather than once per element.
+*/
+template <typename T>
+class SpscQueue 
+{
+private:
+    std::unique_ptr<T[]> m_slots;
+    size_t m_mask;
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> m_head{0};  /* Next slot to read, written by the consumer */
+    size_t m_cachedTail = 0;                                  /* Consumer's copy of m_tail */
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> m_tail{0};  /* Next slot to write, written by the producer */
+    size_t m_cachedHead = 0;                                  /* Producer's copy of m_head */
+
+public:
+    /**
+    * @param capacity Minimum number of elements the queue holds before push() blocks.
+    */
+    explicit SpscQueue(size_t capacity)
+        : m_slots(new T[queue_detail::roundCapacity(capacity)]),
+          m_mask(queue_detail::roundCapacity(capacity) - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+    * @brief Moves a value in if there is room.
+    * @return false if the queue is full; value is left untouched.
+    */
+    bool tryPush(T& value) 
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) 
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) 
+            {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Moves the oldest value out if there is one.
+    * @return false if the queue is empty.
+    */
+    bool tryPop(T& value) 
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) 
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) 
+            {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Moves a value in, waiting while the queue is full (backpressure).
+    */
+    void push(T value) 
+    {
+        unsigned attempts = 0;
+        while (!tryPush(value)) 
+        {
+            queue_detail::backoff(attempts);
+        }
+    }
+
+    /**
+    * @brief Moves the oldest value out, waiting while the queue is empty.
+    */
+    void pop(T& value) 
+    {
+        unsigned attempts = 0;
+        while (!tryPop(value)) 
+        {
+            queue_detail::backoff(attempts);
+        }
+    }
+};
+
+/**
+* @class MpmcQueue
+* @brief Lock-free bounded queue for any number of producer and consumer threads.
+*
+* Dmitry Vyukov's bounded MPMC design: every slot carries a sequence number telling
+* producers when it is free and consumers when it is filled, so each operation costs one
+* compare-and-swap on the shared index plus one store on the slot.
+*/
+template <typename T>
+class MpmcQueue 
+{
+private:
+    struct Cell 
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> m_enqueue{0};  /* Next position to write */
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> m_dequeue{0};  /* Next position to read */
+
+public:
+    /**
+    * @param capacity Minimum number of elements the queue holds before push() blocks.
+    */
+    explicit MpmcQueue(size_t capacity)
+        : m_cells(new Cell[queue_detail::roundCapacity(capacity)]),
+          m_mask(queue_detail::roundCapacity(capacity) - 1) 
+    {
+        for (size_t i = 0; i <= m_mask; ++i) 
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+    * @brief Moves a value in if there is room.
+    * @return false if the queue is full; value is left untouched.
+    */
+    bool tryPush(T& value) 
+    {
+        size_t position = m_enqueue.load(std::memory_order_relaxed);
+        for (;;) 
+        {
+            Cell& cell = m_cells[position & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0) 
+            {
+                if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) 
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) 
+            {
+                return false;
+            }
+            else 
+            {
+                position = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+    * @brief Moves the oldest value out if there is one.
+    * @return false if the queue is empty.
+    */
+    bool tryPop(T& value) 
+    {
+        size_t position = m_dequeue.load(std::memory_order_relaxed);
+        for (;;) 
+        {
+            Cell& cell = m_cells[position & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+            if (difference == 0) 
+            {
+                if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) 
+                {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) 
+            {
+                return false;
+            }
+            else 
+            {
+                position = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+    * @brief Moves a value in, waiting while the queue is full (backpressure).
+    */
+    void push(T value) 
+    {
+        unsigned attempts = 0;
+        while (!tryPush(value)) 
+        {
+            queue_detail::backoff(attempts);
+        }
+    }
+
+    /**
+    * @brief Moves the oldest value out, waiting while the queue is empty.
+    */
+    void pop(T& value) 
+    {
+        unsigned attempts = 0;
+        while (!tryPop(value)) 
+        {
+            queue_detail::backoff(attempts);
+        }
+    }
+};
+
+#endif // BOUNDED_QUEUE_HPP
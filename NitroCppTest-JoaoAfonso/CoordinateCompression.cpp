@@ -0,0 +1,15 @@
+#include "CoordinateCompression.h"
+
+#include <algorithm>
+#include <utility>
+
+CoordinateCompression::CoordinateCompression(std::vector<int> values): m_values(std::move(values)) 
+{
+    std::sort(m_values.begin(), m_values.end());
+    m_values.erase(std::unique(m_values.begin(), m_values.end()), m_values.end());
+}
+
+size_t CoordinateCompression::indexOf(int value) const 
+{
+    return static_cast<size_t>(std::lower_bound(m_values.begin(), m_values.end(), value) - m_values.begin());
+}
@@ -0,0 +1,37 @@
+#ifndef COORDINATE_COMPRESSION_HPP
+#define COORDINATE_COMPRESSION_HPP
+
+#include <vector>
+#include <cstddef>
+
+/**
+* @class CoordinateCompression
+* @brief Maps a set of integer coordinates onto the dense index range [0, size()).
+*
+* Sweep-based engines only care about the relative order of rectangle edges, so the
+* edges are sorted and deduplicated once and then addressed by index.
+*/
+class CoordinateCompression 
+{
+private:
+    std::vector<int> m_values;  /* Sorted, unique coordinate values. */
+
+public:
+    /**
+    * @brief Builds the compression from an unsorted list of coordinates (duplicates allowed).
+    * @param values Coordinates to compress.
+    */
+    explicit CoordinateCompression(std::vector<int> values);
+
+    inline size_t size() const { return m_values.size(); }           /* Returns the number of distinct coordinates. */
+    inline int value(size_t index) const { return m_values[index]; } /* Returns the coordinate stored at an index. */
+
+    /**
+    * @brief Returns the index of a coordinate that was part of the input.
+    * @param value A coordinate passed to the constructor.
+    * @return size_t Its position in the sorted, deduplicated order.
+    */
+    size_t indexOf(int value) const;
+};
+
+#endif // COORDINATE_COMPRESSION_HPP
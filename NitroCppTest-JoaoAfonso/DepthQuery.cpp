@@ -0,0 +1,162 @@
+#include "DepthQuery.h"
+#include "CoordinateCompression.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace 
+{
+    /* Range add / global max over the elementary y intervals, with lazy pending adds */
+    class MaxAddSegmentTree 
+    {
+    private:
+        size_t m_size;
+        std::vector<int> m_max;   /* Max of the node's range, including its own pending add. */
+        std::vector<int> m_lazy;  /* Add applied to the whole node range, not yet pushed down. */
+
+        void add(size_t node, size_t lo, size_t hi, size_t begin, size_t end, int delta) 
+        {
+            if (end <= lo || hi <= begin) 
+            {
+                return;
+            }
+
+            if (begin <= lo && hi <= end) 
+            {
+                m_max[node] += delta;
+                m_lazy[node] += delta;
+                return;
+            }
+
+            size_t mid = (lo + hi) / 2;
+            add(2 * node, lo, mid, begin, end, delta);
+            add(2 * node + 1, mid, hi, begin, end, delta);
+            m_max[node] = m_lazy[node] + std::max(m_max[2 * node], m_max[2 * node + 1]);
+        }
+
+    public:
+        explicit MaxAddSegmentTree(size_t size): m_size(size), m_max(4 * size, 0), m_lazy(4 * size, 0) {}
+
+        /* Adds delta to the leaves [begin, end) */
+        void add(size_t begin, size_t end, int delta) 
+        {
+            add(1, 0, m_size, begin, end, delta);
+        }
+
+        int max() const 
+        {
+            return m_max[1];
+        }
+
+        /* Returns a leaf whose value equals max() */
+        size_t argMax() const 
+        {
+            size_t node = 1;
+            size_t lo = 0;
+            size_t hi = m_size;
+            int target = m_max[1];
+
+            while (hi - lo > 1) 
+            {
+                target -= m_lazy[node];
+                size_t mid = (lo + hi) / 2;
+                if (m_max[2 * node] == target) 
+                {
+                    node = 2 * node;
+                    hi = mid;
+                }
+                else 
+                {
+                    node = 2 * node + 1;
+                    lo = mid;
+                }
+            }
+
+            return lo;
+        }
+    };
+
+    /* An x edge; ends sort before starts at the same x so touching rectangles do not stack */
+    struct Event 
+    {
+        int x;
+        bool is_start;
+        size_t index;
+
+        bool operator<(const Event& other) const 
+        {
+            if (x != other.x) 
+            {
+                return x < other.x;
+            }
+            return is_start < other.is_start;
+        }
+    };
+}
+
+IntersectionResult DepthQuery::findMaxDepth(const std::vector<Rectangle>& rectangles) 
+{
+    IntersectionResult result{Rectangle(-1, 0, 0, 0, 0), {}};
+
+    if (rectangles.empty()) 
+    {
+        return result;
+    }
+
+    std::vector<int> y_values;
+    std::vector<Event> events;
+    y_values.reserve(rectangles.size() * 2);
+    events.reserve(rectangles.size() * 2);
+
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        y_values.push_back(rectangles[i].y());
+        y_values.push_back(rectangles[i].bottom());
+        events.push_back({rectangles[i].x(), true, i});
+        events.push_back({rectangles[i].right(), false, i});
+    }
+
+    const CoordinateCompression ys(std::move(y_values));
+    std::sort(events.begin(), events.end());
+
+    MaxAddSegmentTree tree(ys.size() - 1);
+    int best_depth = 0;
+    int best_x = 0;
+    int best_right = 0;
+    size_t best_leaf = 0;
+
+    for (size_t e = 0; e < events.size(); ) 
+    {
+        /* Apply every event at this x before looking at the slab that follows it */
+        const int x = events[e].x;
+        for (; e < events.size() && events[e].x == x; ++e) 
+        {
+            const auto& rect = rectangles[events[e].index];
+            tree.add(ys.indexOf(rect.y()), ys.indexOf(rect.bottom()), events[e].is_start ? 1 : -1);
+        }
+
+        if (e < events.size() && tree.max() > best_depth) 
+        {
+            best_depth = tree.max();
+            best_x = x;
+            best_right = events[e].x;
+            best_leaf = tree.argMax();
+        }
+    }
+
+    const int best_y = ys.value(best_leaf);
+    result.rect = Rectangle(-1, best_x, best_y, best_right - best_x, ys.value(best_leaf + 1) - best_y);
+
+    /* The witness is an elementary cell, so any rectangle overlapping it covers it entirely */
+    Rectangle overlap(-1, 0, 0, 0, 0);
+    for (const auto& rect : rectangles) 
+    {
+        if (Rectangle::calculate_intersection(rect, result.rect, overlap)) 
+        {
+            result.parent_ids.push_back(rect.id());
+        }
+    }
+    std::sort(result.parent_ids.begin(), result.parent_ids.end());
+
+    return result;
+}
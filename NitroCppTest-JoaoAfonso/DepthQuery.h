@@ -0,0 +1,32 @@
+#ifndef DEPTH_QUERY_HPP
+#define DEPTH_QUERY_HPP
+
+#include <vector>
+#include "Rectangle.h"
+#include "IntersectionFinder.h"
+
+/**
+* @class DepthQuery
+* @brief Finds the point covered by the largest number of rectangles in O(n log n).
+*
+* Sweeps the x edges and keeps, over the compressed y intervals, a segment tree supporting
+* range add with lazy propagation and a global maximum. The maximum observed between two
+* consecutive x edges is the answer.
+*/
+class DepthQuery 
+{
+public:
+    /**
+    * @brief Computes the maximum overlap depth with a witness region.
+    *
+    * The depth is parent_ids.size(). The witness region in 'rect' is an elementary cell of
+    * the compressed grid, so every point inside it is covered by exactly the reported
+    * rectangles. For an empty input, parent_ids is empty and 'rect' has zero size.
+    *
+    * @param rectangles Input rectangles (positive width and height).
+    * @return IntersectionResult The witness region and the IDs of the rectangles covering it (ascending).
+    */
+    static IntersectionResult findMaxDepth(const std::vector<Rectangle>& rectangles);
+};
+
+#endif // DEPTH_QUERY_HPP
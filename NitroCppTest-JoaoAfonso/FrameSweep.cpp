@@ -0,0 +1,198 @@
+#include "FrameSweep.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace 
+{
+    inline uint64_t pairKey(uint32_t a, uint32_t b) 
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    inline int lowEdge(const Rectangle& rect, int axis) 
+    {
+        return axis == 0 ? rect.x() : rect.y();
+    }
+
+    inline int highEdge(const Rectangle& rect, int axis) 
+    {
+        return axis == 0 ? rect.right() : rect.bottom();
+    }
+}
+
+FrameSweep::FrameSweep(const std::vector<Rectangle>& frame): m_boxes(frame) 
+{
+    for (int axis = 0; axis < 2; ++axis) 
+    {
+        buildAxis(axis);
+    }
+
+    m_touched.clear();
+}
+
+void FrameSweep::buildAxis(int axis) 
+{
+    auto& endpoints = m_axes[axis];
+    endpoints.clear();
+    endpoints.reserve(m_boxes.size() * 2);
+
+    for (uint32_t box = 0; box < m_boxes.size(); ++box) 
+    {
+        endpoints.push_back({lowEdge(m_boxes[box], axis), box, true});
+        endpoints.push_back({highEdge(m_boxes[box], axis), box, false});
+    }
+
+    std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& a, const Endpoint& b) {
+        return a.value != b.value ? a.value < b.value : a.is_begin < b.is_begin;
+    });
+
+    /* Initial overlaps on this axis: every box open when another begins */
+    std::vector<uint32_t> open;
+    for (const auto& endpoint : endpoints) 
+    {
+        if (endpoint.is_begin) 
+        {
+            for (uint32_t other : open) 
+            {
+                toggle(endpoint.box, other, axis);
+            }
+            open.push_back(endpoint.box);
+        }
+        else 
+        {
+            open.erase(std::find(open.begin(), open.end(), endpoint.box));
+        }
+    }
+}
+
+void FrameSweep::toggle(uint32_t a, uint32_t b, int axis) 
+{
+    const uint64_t key = pairKey(a, b);
+    uint8_t& axes = m_pairs[key];
+    const bool was_overlapping = axes == 3;
+
+    m_touched.emplace(key, was_overlapping);
+    axes ^= static_cast<uint8_t>(1u << axis);
+
+    if (axes == 3) 
+    {
+        ++m_overlapCount;
+    }
+    else if (was_overlapping) 
+    {
+        --m_overlapCount;
+    }
+
+    if (axes == 0) 
+    {
+        m_pairs.erase(key);
+    }
+}
+
+void FrameSweep::repairAxis(int axis) 
+{
+    auto& endpoints = m_axes[axis];
+
+    for (auto& endpoint : endpoints) 
+    {
+        const auto& box = m_boxes[endpoint.box];
+        endpoint.value = endpoint.is_begin ? lowEdge(box, axis) : highEdge(box, axis);
+    }
+
+    /* Insertion sort; every swap of a begin and an end changes that pair's overlap on this axis */
+    for (size_t i = 1; i < endpoints.size(); ++i) 
+    {
+        for (size_t j = i; j > 0; --j) 
+        {
+            Endpoint& moving = endpoints[j];
+            Endpoint& previous = endpoints[j - 1];
+
+            const bool out_of_order = moving.value < previous.value ||
+                                      (moving.value == previous.value && !moving.is_begin && previous.is_begin);
+            if (!out_of_order) 
+            {
+                break;
+            }
+
+            if (moving.is_begin != previous.is_begin) 
+            {
+                toggle(moving.box, previous.box, axis);
+            }
+
+            std::swap(moving, previous);
+            ++m_swapCount;
+        }
+    }
+}
+
+void FrameSweep::update(const std::vector<Rectangle>& frame) 
+{
+    if (frame.size() != m_boxes.size()) 
+    {
+        throw std::invalid_argument("Frame must contain the same rectangles as the first frame.");
+    }
+
+    m_boxes = frame;
+    m_added.clear();
+    m_removed.clear();
+    m_touched.clear();
+    m_swapCount = 0;
+
+    for (int axis = 0; axis < 2; ++axis) 
+    {
+        repairAxis(axis);
+    }
+
+    /* Report net changes only: a pair toggled off and on again within the frame is unchanged */
+    for (const auto& touched : m_touched) 
+    {
+        auto found = m_pairs.find(touched.first);
+        const bool overlapping = found != m_pairs.end() && found->second == 3;
+
+        if (overlapping && !touched.second) 
+        {
+            m_added.push_back(idsOf(touched.first));
+        }
+        else if (!overlapping && touched.second) 
+        {
+            m_removed.push_back(idsOf(touched.first));
+        }
+    }
+
+    std::sort(m_added.begin(), m_added.end());
+    std::sort(m_removed.begin(), m_removed.end());
+}
+
+std::pair<int, int> FrameSweep::idsOf(uint64_t key) const 
+{
+    int a = m_boxes[static_cast<uint32_t>(key >> 32)].id();
+    int b = m_boxes[static_cast<uint32_t>(key)].id();
+    return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+std::vector<IntersectionResult> FrameSweep::overlaps() const 
+{
+    std::vector<IntersectionResult> results;
+    results.reserve(m_overlapCount);
+
+    for (const auto& pair : m_pairs) 
+    {
+        if (pair.second == 3) 
+        {
+            const auto& a = m_boxes[static_cast<uint32_t>(pair.first >> 32)];
+            const auto& b = m_boxes[static_cast<uint32_t>(pair.first)];
+            Rectangle region(-1, 0, 0, 0, 0);
+            Rectangle::calculate_intersection(a, b, region);
+
+            auto ids = idsOf(pair.first);
+            results.push_back({region, {ids.first, ids.second}});
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const IntersectionResult& a, const IntersectionResult& b) {
+        return a.parent_ids < b.parent_ids;
+    });
+
+    return results;
+}
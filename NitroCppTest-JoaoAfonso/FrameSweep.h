@@ -0,0 +1,84 @@
+#ifndef FRAME_SWEEP_HPP
+#define FRAME_SWEEP_HPP
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include "Rectangle.h"
+#include "IntersectionFinder.h"
+
+/**
+* @class FrameSweep
+* @brief Persistent sort-and-sweep state for overlap pairs across animation frames.
+*
+* Keeps the interval endpoints of every rectangle in one sorted list per axis. Between frames
+* the lists are repaired with insertion sort, which is nearly linear when rectangles move
+* only slightly. Each swap between the begin of one rectangle and the end of another toggles
+* their overlap on that axis, and a pair overlaps when it overlaps on both axes. Per-frame cost
+* therefore follows the number of endpoint swaps (the amount of motion), not n log n.
+*/
+class FrameSweep 
+{
+private:
+    /* One interval endpoint on an axis; at equal values ends sort first so touching is not overlap */
+    struct Endpoint 
+    {
+        int value;
+        uint32_t box;
+        bool is_begin;
+    };
+
+    std::vector<Rectangle> m_boxes;                  /* Rectangles of the current frame. */
+    std::vector<Endpoint> m_axes[2];                 /* Sorted endpoints along x and y. */
+    std::unordered_map<uint64_t, uint8_t> m_pairs;   /* Pair key -> axes (bit 0: x, bit 1: y) on which the pair overlaps. */
+    std::unordered_map<uint64_t, bool> m_touched;    /* Pair key -> whether it overlapped before the current update. */
+    std::vector<std::pair<int, int>> m_added;        /* Pairs that started overlapping in the last update. */
+    std::vector<std::pair<int, int>> m_removed;      /* Pairs that stopped overlapping in the last update. */
+    size_t m_overlapCount = 0;                       /* Number of pairs overlapping on both axes. */
+    size_t m_swapCount = 0;                          /* Endpoint swaps performed by the last update. */
+
+    void buildAxis(int axis);
+    void repairAxis(int axis);
+    void toggle(uint32_t a, uint32_t b, int axis);
+    std::pair<int, int> idsOf(uint64_t key) const;
+
+public:
+    /**
+    * @brief Builds the sweep state for the first frame.
+    * @param frame Rectangles of the first frame (positive width and height).
+    */
+    explicit FrameSweep(const std::vector<Rectangle>& frame);
+
+    /**
+    * @brief Advances to the next frame, updating the overlap pairs incrementally.
+    *
+    * The frame must contain the same rectangles, in the same order, as the first frame;
+    * only their positions and sizes may change.
+    *
+    * @param frame Rectangles of the next frame.
+    * @throws std::invalid_argument if the frame has a different number of rectangles.
+    */
+    void update(const std::vector<Rectangle>& frame);
+
+    /**
+    * @brief Returns the ID pairs (smaller ID first) that began overlapping in the last update.
+    */
+    inline const std::vector<std::pair<int, int>>& added() const { return m_added; }
+
+    /**
+    * @brief Returns the ID pairs (smaller ID first) that stopped overlapping in the last update.
+    */
+    inline const std::vector<std::pair<int, int>>& removed() const { return m_removed; }
+
+    inline size_t overlapCount() const { return m_overlapCount; }  /* Returns the number of overlapping pairs. */
+    inline size_t swapCount() const { return m_swapCount; }        /* Returns the endpoint swaps done by the last update. */
+
+    /**
+    * @brief Materializes the current overlapping pairs with their common regions.
+    * @return std::vector<IntersectionResult> One result per pair, IDs ascending, sorted by IDs.
+    */
+    std::vector<IntersectionResult> overlaps() const;
+};
+
+#endif // FRAME_SWEEP_HPP
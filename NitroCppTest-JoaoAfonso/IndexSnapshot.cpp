@@ -0,0 +1,403 @@
+#include "IndexSnapshot.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace 
+{
+    const char kMagic[8] = {'N', 'R', 'I', 'N', 'D', 'E', 'X', '\0'};
+    const uint32_t kByteOrder = 0x01020304u;
+    const uint64_t kAlignment = 64;
+
+    uint64_t alignUp(uint64_t offset) 
+    {
+        return (offset + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    int64_t floorDiv(int64_t value, int64_t divisor) 
+    {
+        int64_t quotient = value / divisor;
+        return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+    }
+
+    /* True if count elements of the given size starting at offset lie inside the file and are aligned */
+    bool sectionFits(uint64_t offset, uint64_t count, uint64_t element, uint64_t file_size) 
+    {
+        return offset % kAlignment == 0 && offset <= file_size && count <= (file_size - offset) / element;
+    }
+
+    template <typename T>
+    void writeSection(std::ofstream& out, uint64_t offset, const std::vector<T>& values) 
+    {
+        static const char padding[kAlignment] = {};
+        out.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(out.tellp())));
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+}
+
+void IndexSnapshot::write(const std::string& path, const std::vector<Rectangle>& rectangles) 
+{
+    const uint64_t count = rectangles.size();
+    if (count > std::numeric_limits<uint32_t>::max()) 
+    {
+        throw std::runtime_error("Too many rectangles for an index snapshot.");
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = INDEX_SNAPSHOT_VERSION;
+    header.byte_order = kByteOrder;
+    header.count = count;
+
+    /* Grid geometry: about one cell per rectangle over the bounding box. Cells are at least 1/count
+       of the longer side, so an elongated scene gets one row of at most count cells rather than
+       a grid sized by its area; either way columns * rows stays below 3 * count + 2. */
+    int64_t left = 0, top = 0, right = 1, bottom = 1;
+    if (count > 0) 
+    {
+        left = top = std::numeric_limits<int64_t>::max();
+        right = bottom = std::numeric_limits<int64_t>::min();
+        for (const auto& rect : rectangles) 
+        {
+            left = std::min<int64_t>(left, rect.x());
+            top = std::min<int64_t>(top, rect.y());
+            right = std::max<int64_t>(right, int64_t(rect.x()) + rect.w());
+            bottom = std::max<int64_t>(bottom, int64_t(rect.y()) + rect.h());
+        }
+    }
+
+    const double area = double(right - left) * double(bottom - top);
+    header.origin_x = left;
+    header.origin_y = top;
+    const int64_t longer_side = std::max(right - left, bottom - top);
+    const int64_t per_count = std::max<uint64_t>(1, count);
+    header.cell_size = std::max<int64_t>({1, static_cast<int64_t>(std::ceil(std::sqrt(area / double(per_count)))),
+                                          (longer_side + per_count - 1) / per_count});
+    header.columns = static_cast<uint64_t>((right - left + header.cell_size - 1) / header.cell_size);
+    header.rows = static_cast<uint64_t>((bottom - top + header.cell_size - 1) / header.cell_size);
+
+    /* Counting pass, then a prefix sum and a filling pass: the compressed sparse row layout */
+    const uint64_t cells = header.columns * header.rows;
+    std::vector<uint64_t> offsets(cells + 1, 0);
+    std::vector<uint32_t> large;
+    std::vector<char> in_grid(count, 0);
+
+    auto span = [&header](const Rectangle& rect, int64_t& c0, int64_t& c1, int64_t& r0, int64_t& r1) {
+        c0 = (rect.x() - header.origin_x) / header.cell_size;
+        c1 = (int64_t(rect.x()) + rect.w() - 1 - header.origin_x) / header.cell_size;
+        r0 = (rect.y() - header.origin_y) / header.cell_size;
+        r1 = (int64_t(rect.y()) + rect.h() - 1 - header.origin_y) / header.cell_size;
+    };
+
+    for (uint64_t i = 0; i < count; ++i) 
+    {
+        int64_t c0, c1, r0, r1;
+        span(rectangles[i], c0, c1, r0, r1);
+        if ((c1 - c0 + 1) * (r1 - r0 + 1) > INDEX_SNAPSHOT_MAX_CELLS_PER_RECTANGLE) 
+        {
+            large.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+
+        in_grid[i] = 1;
+        for (int64_t r = r0; r <= r1; ++r) 
+        {
+            for (int64_t c = c0; c <= c1; ++c) 
+            {
+                ++offsets[r * header.columns + c + 1];
+            }
+        }
+    }
+
+    for (uint64_t cell = 0; cell < cells; ++cell) 
+    {
+        offsets[cell + 1] += offsets[cell];
+    }
+
+    std::vector<uint32_t> entries(offsets[cells]);
+    std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint64_t i = 0; i < count; ++i) 
+    {
+        if (in_grid[i]) 
+        {
+            int64_t c0, c1, r0, r1;
+            span(rectangles[i], c0, c1, r0, r1);
+            for (int64_t r = r0; r <= r1; ++r) 
+            {
+                for (int64_t c = c0; c <= c1; ++c) 
+                {
+                    entries[cursor[r * header.columns + c]++] = static_cast<uint32_t>(i);
+                }
+            }
+        }
+    }
+
+    std::vector<int32_t> ids, xs, ys, ws, hs;
+    for (const auto& rect : rectangles) 
+    {
+        ids.push_back(rect.id());
+        xs.push_back(rect.x());
+        ys.push_back(rect.y());
+        ws.push_back(rect.w());
+        hs.push_back(rect.h());
+    }
+
+    header.entry_count = entries.size();
+    header.large_count = large.size();
+    header.ids_offset = alignUp(sizeof(Header));
+    header.xs_offset = alignUp(header.ids_offset + count * sizeof(int32_t));
+    header.ys_offset = alignUp(header.xs_offset + count * sizeof(int32_t));
+    header.ws_offset = alignUp(header.ys_offset + count * sizeof(int32_t));
+    header.hs_offset = alignUp(header.ws_offset + count * sizeof(int32_t));
+    header.cells_offset = alignUp(header.hs_offset + count * sizeof(int32_t));
+    header.entries_offset = alignUp(header.cells_offset + offsets.size() * sizeof(uint64_t));
+    header.large_offset = alignUp(header.entries_offset + entries.size() * sizeof(uint32_t));
+    header.file_size = header.large_offset + large.size() * sizeof(uint32_t);
+
+    /* Write next to the target and rename, so a process mapping the old file is never disturbed. The
+       temporary name is unique per process and thread, since several writers may produce the same file. */
+    std::ostringstream suffix;
+    suffix << ".tmp" << getpid() << "." << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temporary = path + suffix.str(); 
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) 
+        {
+            throw std::runtime_error("Could not write index snapshot: " + path);
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(out, header.ids_offset, ids);
+        writeSection(out, header.xs_offset, xs);
+        writeSection(out, header.ys_offset, ys);
+        writeSection(out, header.ws_offset, ws);
+        writeSection(out, header.hs_offset, hs);
+        writeSection(out, header.cells_offset, offsets);
+        writeSection(out, header.entries_offset, entries);
+        writeSection(out, header.large_offset, large);
+
+        if (!out) 
+        {
+            out.close();
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Could not write index snapshot: " + path);
+        }
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) 
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Could not write index snapshot: " + path);
+    }
+}
+
+bool IndexSnapshot::isSnapshot(const std::string& path) 
+{
+    char magic[sizeof(kMagic)];
+    std::ifstream in(path, std::ios::binary);
+    return in.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), kMagic);
+}
+
+IndexSnapshot IndexSnapshot::open(const std::string& path) 
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) 
+    {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < sizeof(Header)) 
+    {
+        ::close(fd);
+        throw std::runtime_error("Not an index snapshot: " + path);
+    }
+
+    IndexSnapshot snapshot;
+    snapshot.m_mappingSize = static_cast<size_t>(status.st_size);
+    snapshot.m_mapping = mmap(nullptr, snapshot.m_mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (snapshot.m_mapping == MAP_FAILED) 
+    {
+        snapshot.m_mapping = nullptr;
+        throw std::runtime_error("Could not map file: " + path);
+    }
+
+    const char* base = static_cast<const char*>(snapshot.m_mapping);
+    const Header& header = *reinterpret_cast<const Header*>(base);
+    const uint64_t size = snapshot.m_mappingSize;
+
+    /* Every section is bounds-checked once here, so queries can index the arrays directly */
+    bool valid = std::equal(kMagic, kMagic + sizeof(kMagic), header.magic) && header.byte_order == kByteOrder &&
+                 header.file_size == size && header.count <= std::numeric_limits<uint32_t>::max() &&
+                 header.cell_size >= 1 && header.columns <= size && header.rows <= size &&
+                 (header.rows == 0 || header.columns <= size / header.rows);
+
+    if (valid && header.version != INDEX_SNAPSHOT_VERSION) 
+    {
+        throw std::runtime_error("Unsupported index snapshot version " + std::to_string(header.version) + ": " + path);
+    }
+
+    const uint64_t cells = valid ? header.columns * header.rows : 0;
+    valid = valid && sectionFits(header.ids_offset, header.count, sizeof(int32_t), size) &&
+            sectionFits(header.xs_offset, header.count, sizeof(int32_t), size) &&
+            sectionFits(header.ys_offset, header.count, sizeof(int32_t), size) &&
+            sectionFits(header.ws_offset, header.count, sizeof(int32_t), size) &&
+            sectionFits(header.hs_offset, header.count, sizeof(int32_t), size) &&
+            sectionFits(header.cells_offset, cells + 1, sizeof(uint64_t), size) &&
+            sectionFits(header.entries_offset, header.entry_count, sizeof(uint32_t), size) &&
+            sectionFits(header.large_offset, header.large_count, sizeof(uint32_t), size);
+
+    if (!valid) 
+    {
+        throw std::runtime_error("Not an index snapshot: " + path);
+    }
+
+    snapshot.m_header = &header;
+    snapshot.m_ids = reinterpret_cast<const int32_t*>(base + header.ids_offset);
+    snapshot.m_xs = reinterpret_cast<const int32_t*>(base + header.xs_offset);
+    snapshot.m_ys = reinterpret_cast<const int32_t*>(base + header.ys_offset);
+    snapshot.m_ws = reinterpret_cast<const int32_t*>(base + header.ws_offset);
+    snapshot.m_hs = reinterpret_cast<const int32_t*>(base + header.hs_offset);
+    snapshot.m_cells = reinterpret_cast<const uint64_t*>(base + header.cells_offset);
+    snapshot.m_entries = reinterpret_cast<const uint32_t*>(base + header.entries_offset);
+    snapshot.m_large = reinterpret_cast<const uint32_t*>(base + header.large_offset);
+
+    if (snapshot.m_cells[0] != 0 || snapshot.m_cells[cells] != header.entry_count) 
+    {
+        throw std::runtime_error("Not an index snapshot: " + path);
+    }
+
+    return snapshot;
+}
+
+IndexSnapshot::IndexSnapshot(IndexSnapshot&& other) noexcept 
+{
+    *this = std::move(other);
+}
+
+IndexSnapshot& IndexSnapshot::operator=(IndexSnapshot&& other) noexcept 
+{
+    if (this != &other) 
+    {
+        release();
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_mappingSize = std::exchange(other.m_mappingSize, 0);
+        m_header = std::exchange(other.m_header, nullptr);
+        m_ids = other.m_ids;
+        m_xs = other.m_xs;
+        m_ys = other.m_ys;
+        m_ws = other.m_ws;
+        m_hs = other.m_hs;
+        m_cells = other.m_cells;
+        m_entries = other.m_entries;
+        m_large = other.m_large;
+    }
+    return *this;
+}
+
+IndexSnapshot::~IndexSnapshot() 
+{
+    release();
+}
+
+void IndexSnapshot::release() 
+{
+    if (m_mapping != nullptr) 
+    {
+        munmap(m_mapping, m_mappingSize);
+        m_mapping = nullptr;
+    }
+}
+
+Rectangle IndexSnapshot::rectangle(size_t position) const 
+{
+    return Rectangle(m_ids[position], m_xs[position], m_ys[position], m_ws[position], m_hs[position]);
+}
+
+std::vector<Rectangle> IndexSnapshot::rectangles() const 
+{
+    std::vector<Rectangle> result;
+    result.reserve(size());
+    for (size_t position = 0; position < size(); ++position) 
+    {
+        result.push_back(rectangle(position));
+    }
+    return result;
+}
+
+bool IndexSnapshot::overlaps(uint32_t position, int64_t left, int64_t top, int64_t right, int64_t bottom) const 
+{
+    return m_xs[position] < right && int64_t(m_xs[position]) + m_ws[position] > left &&
+           m_ys[position] < bottom && int64_t(m_ys[position]) + m_hs[position] > top;
+}
+
+std::vector<int> IndexSnapshot::query(const Rectangle& window) const 
+{
+    const Header& header = *m_header;
+    const int64_t left = window.x();
+    const int64_t top = window.y();
+    const int64_t right = left + window.w();
+    const int64_t bottom = top + window.h();
+    std::vector<int> ids;
+
+    for (uint64_t i = 0; i < header.large_count; ++i) 
+    {
+        if (m_large[i] < header.count && overlaps(m_large[i], left, top, right, bottom)) 
+        {
+            ids.push_back(m_ids[m_large[i]]);
+        }
+    }
+
+    const int64_t c0 = std::max<int64_t>(0, floorDiv(left - header.origin_x, header.cell_size));
+    const int64_t c1 = std::min<int64_t>(int64_t(header.columns) - 1, floorDiv(right - 1 - header.origin_x, header.cell_size));
+    const int64_t r0 = std::max<int64_t>(0, floorDiv(top - header.origin_y, header.cell_size));
+    const int64_t r1 = std::min<int64_t>(int64_t(header.rows) - 1, floorDiv(bottom - 1 - header.origin_y, header.cell_size));
+
+    for (int64_t r = r0; r <= r1; ++r) 
+    {
+        for (int64_t c = c0; c <= c1; ++c) 
+        {
+            const uint64_t cell = uint64_t(r) * header.columns + uint64_t(c);
+            const uint64_t end = std::min(m_cells[cell + 1], header.entry_count);
+
+            for (uint64_t k = m_cells[cell]; k < end; ++k) 
+            {
+                const uint32_t position = m_entries[k];
+                if (position >= header.count || !overlaps(position, left, top, right, bottom)) 
+                {
+                    continue;
+                }
+
+                /* A rectangle spanning several visited cells is reported from the first of them only */
+                const int64_t first_c = std::max(c0, (m_xs[position] - header.origin_x) / header.cell_size);
+                const int64_t first_r = std::max(r0, (m_ys[position] - header.origin_y) / header.cell_size);
+                if (first_c == c && first_r == r) 
+                {
+                    ids.push_back(m_ids[position]);
+                }
+            }
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::vector<int> IndexSnapshot::stab(int x, int y) const 
+{
+    return query(Rectangle(-1, x, y, 1, 1));
+}
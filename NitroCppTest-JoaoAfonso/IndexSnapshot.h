@@ -0,0 +1,135 @@
+#ifndef INDEX_SNAPSHOT_HPP
+#define INDEX_SNAPSHOT_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Rectangle.h"
+
+/* Layout version written to and required from snapshot files */
+#define INDEX_SNAPSHOT_VERSION 1u
+
+/* Rectangles touching more grid cells than this are kept in a list scanned by every query */
+#define INDEX_SNAPSHOT_MAX_CELLS_PER_RECTANGLE 256
+
+/**
+* @class IndexSnapshot
+* @brief Read-only rectangle index stored in a file that is used in place through mmap.
+*
+* write() freezes a scene and a uniform grid over it into one file:
+* - a fixed header with a magic string, the layout version and the grid geometry;
+* - the rectangles as separate ID, x, y, w and h arrays;
+* - the grid in compressed sparse row form: per-cell offsets into one array of rectangle
+*   positions, plus the positions of rectangles too large for the grid.
+* Every section is addressed by its byte offset from the start of the file and aligned to
+* 64 bytes, so the file can be mapped at any address and used without parsing or building
+* anything. Pages are loaded lazily by the kernel as queries touch them and are shared
+* between processes mapping the same file.
+*/
+class IndexSnapshot 
+{
+public:
+    /**
+    * @struct Header
+    * @brief Fixed-size header at offset 0 of a snapshot file.
+    */
+    struct Header 
+    {
+        char magic[8];              /* "NRINDEX\0" */
+        uint32_t version;           /* INDEX_SNAPSHOT_VERSION */
+        uint32_t byte_order;        /* 0x01020304 as written by the producing machine */
+        uint64_t file_size;         /* Total size of the file in bytes */
+        uint64_t count;             /* Number of rectangles */
+        int64_t origin_x;           /* Left edge of the grid */
+        int64_t origin_y;           /* Top edge of the grid */
+        int64_t cell_size;          /* Side length of a grid cell */
+        uint64_t columns;           /* Grid columns */
+        uint64_t rows;              /* Grid rows */
+        uint64_t entry_count;       /* Length of the entries section */
+        uint64_t large_count;       /* Length of the large section */
+        uint64_t ids_offset;        /* int32_t[count] */
+        uint64_t xs_offset;         /* int32_t[count] */
+        uint64_t ys_offset;         /* int32_t[count] */
+        uint64_t ws_offset;         /* int32_t[count] */
+        uint64_t hs_offset;         /* int32_t[count] */
+        uint64_t cells_offset;      /* uint64_t[columns * rows + 1], start of each cell in entries */
+        uint64_t entries_offset;    /* uint32_t[entry_count], rectangle positions by cell */
+        uint64_t large_offset;      /* uint32_t[large_count], positions of rectangles kept out of the grid */
+    };
+
+private:
+    void* m_mapping = nullptr;     /* Start of the mapped file */
+    size_t m_mappingSize = 0;      /* Length of the mapping */
+    const Header* m_header = nullptr;
+    const int32_t* m_ids = nullptr;
+    const int32_t* m_xs = nullptr;
+    const int32_t* m_ys = nullptr;
+    const int32_t* m_ws = nullptr;
+    const int32_t* m_hs = nullptr;
+    const uint64_t* m_cells = nullptr;
+    const uint32_t* m_entries = nullptr;
+    const uint32_t* m_large = nullptr;
+
+    IndexSnapshot() = default;
+    void release();
+
+    /* True if the rectangle at a position overlaps the window */
+    bool overlaps(uint32_t position, int64_t left, int64_t top, int64_t right, int64_t bottom) const;
+
+public:
+    /**
+    * @brief Builds the index over a scene and writes it to a file, replacing it atomically.
+    * @param path Destination file.
+    * @param rectangles The scene; rectangles must have positive width and height.
+    * @throws std::runtime_error if the file cannot be written.
+    */
+    static void write(const std::string& path, const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Maps a snapshot file.
+    * @param path File written by write().
+    * @return The mapped snapshot.
+    * @throws std::runtime_error if the file cannot be mapped or is not a valid snapshot of this version.
+    */
+    static IndexSnapshot open(const std::string& path);
+
+    /**
+    * @brief Returns true if a file starts with the snapshot magic string.
+    */
+    static bool isSnapshot(const std::string& path);
+
+    IndexSnapshot(IndexSnapshot&& other) noexcept;
+    IndexSnapshot& operator=(IndexSnapshot&& other) noexcept;
+    IndexSnapshot(const IndexSnapshot&) = delete;
+    IndexSnapshot& operator=(const IndexSnapshot&) = delete;
+
+    /**
+    * @brief Unmaps the file.
+    */
+    ~IndexSnapshot();
+
+    inline size_t size() const { return static_cast<size_t>(m_header->count); }  /* Returns the number of rectangles. */
+
+    /**
+    * @brief Returns the rectangle stored at a position.
+    */
+    Rectangle rectangle(size_t position) const;
+
+    /**
+    * @brief Copies every rectangle out of the snapshot, in stored order.
+    */
+    std::vector<Rectangle> rectangles() const;
+
+    /**
+    * @brief Returns the sorted IDs of the rectangles overlapping a window with positive area.
+    */
+    std::vector<int> query(const Rectangle& window) const;
+
+    /**
+    * @brief Returns the sorted IDs of the rectangles containing the unit cell at (x, y).
+    */
+    std::vector<int> stab(int x, int y) const;
+};
+
+#endif // INDEX_SNAPSHOT_HPP
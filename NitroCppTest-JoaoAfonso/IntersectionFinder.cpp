@@ -1,156 +1,787 @@
-#include "IntersectionFinder.h"
-
-#include <iostream>
-#include <sstream>
-#include <stdexcept>
-#include <algorithm>
-
-IntersectionFinder::IntersectionFinder() = default;
-
-void IntersectionFinder::loadRectanglesFromFile(const std::string& filename) 
-{
-    m_inputRectangles = Rectangle::loadFromFile(filename);
-    
-    if (m_inputRectangles.size() < 2)
-    {
-        throw std::runtime_error("Not Possible to find intersections with only one valid rectangle.");
-    }
-}
-
-/* Creates a unique sorted key for a group of rectangles */
-std::string IntersectionFinder::createKey(const std::vector<int>& ids) 
-{
-    std::vector<int> sorted = ids;
-    std::sort(sorted.begin(), sorted.end());
-
-    std::string key = std::to_string(sorted[0]);
-
-    for (size_t i = 1; i < sorted.size(); ++i) 
-    { 
-        key += "-";
-        key += std::to_string(sorted[i]);
-    }
-    
-    return key;
-}
-
-bool IntersectionFinder::recordIntersectionIfUnique(const Rectangle& rect, const std::vector<int>& parent_ids) 
-{
-    bool boReturn = false;
-
-    std::string key = createKey(parent_ids);
-
-    if (std::find(m_processedKeys.begin(), m_processedKeys.end(), key) == m_processedKeys.end()) 
-    {
-        m_processedKeys.push_back(key);
-        m_intersections.push_back({rect, parent_ids});
-
-        boReturn = true;
-    }
-
-    return boReturn;
-}
-
-
-void IntersectionFinder::processIntersections() 
-{
-    for (size_t i = 0; i < m_inputRectangles.size(); ++i) 
-    {
-        for (size_t j = i + 1; j < m_inputRectangles.size(); ++j) 
-        {
-            const auto& r1 = m_inputRectangles[i];
-            const auto& r2 = m_inputRectangles[j];
-
-            Rectangle intersection(-1, 0, 0, 0, 0);
-            if (Rectangle::calculate_intersection(r1, r2, intersection)) 
-            {
-                std::vector<int> parent_ids = {r1.id(), r2.id()};
-                if (recordIntersectionIfUnique(intersection, parent_ids)) 
-                {
-                    find_intersections_recursive(intersection, parent_ids, j + 1);
-                }
-            }
-        }
-    }
-}
-
-void IntersectionFinder::find_intersections_recursive(const Rectangle& current_intersection, const std::vector<int>& parent_ids, size_t start_index) 
-{
-    for (size_t i = start_index; i < m_inputRectangles.size(); ++i) 
-    {
-        const auto& next_rect = m_inputRectangles[i];
-        Rectangle new_intersection(-1, 0, 0, 0, 0);
-
-        if (Rectangle::calculate_intersection(current_intersection, next_rect, new_intersection)) 
-        {
-            std::vector<int> new_parent_ids = parent_ids;
-            new_parent_ids.push_back(next_rect.id());
-
-            if (recordIntersectionIfUnique(new_intersection, new_parent_ids)) 
-            {
-                find_intersections_recursive(new_intersection, new_parent_ids, i + 1);
-            }
-        }
-    }
-}
-
-void IntersectionFinder::printResults() 
-{
-    std::cout << "Input:\n";
-    for (const auto& rect : m_inputRectangles) 
-    {
-        std::cout << "\t" << rect.id() << ": Rectangle at ("
-                  << rect.x() << "," << rect.y() << "), "
-                  << "w=" << rect.w() << ", h=" << rect.h() << ".\n";
-    }
-
-    std::cout << "Intersections:\n";
-
-    if (m_intersections.empty()) 
-    {
-        std::cout << "No intersections found.\n";
-        return;
-    }
-
-    std::vector<IntersectionResult> sorted = m_intersections;
-
-    std::sort(sorted.begin(), sorted.end(), [](const IntersectionResult& a, const IntersectionResult& b) {
-    /* First: by number of rectangles involved (ascending) */
-    if (a.parent_ids.size() != b.parent_ids.size()) 
-    {
-        return a.parent_ids.size() < b.parent_ids.size();
-    }
-
-    /* Second: by the smallest rectangle ID in the intersection */
-    auto sorted_a = a.parent_ids, sorted_b = b.parent_ids;
-    std::sort(sorted_a.begin(), sorted_a.end());
-    std::sort(sorted_b.begin(), sorted_b.end());
-
-    return sorted_a < sorted_b;
-    });
-
-    for (size_t i = 0; i < sorted.size(); ++i) 
-    {
-        const auto& result = sorted[i];
-
-        std::cout << "\tBetween rectangle ";
-
-        for (size_t j = 0; j < result.parent_ids.size(); ++j) 
-        {
-            std::cout << result.parent_ids[j];
-            if (j + 2 == result.parent_ids.size()) 
-            {
-                std::cout << " and ";
-            } 
-            else if (j + 1 < result.parent_ids.size()) 
-            {
-                std::cout << ", ";
-            }
-        }
-
-        const auto& rect = result.rect;
-        std::cout << " at (" << rect.x() << "," << rect.y()
-                  << "), w=" << rect.w() << ", h=" << rect.h() << ".\n";
-    }
-}
-    
\ No newline at end of file
+#include "IntersectionFinder.h"
+#include "ArrangementEngine.h"
+#include "OverlapCounter.h"
+#include "OrderCounter.h"
+#include "DepthQuery.h"
+#include "RasterCoverage.h"
+#include "RunStats.h"
+#include "TraceRecorder.h"
+#include "ThreadPool.h"
+#include "SubsetEngine.h"
+
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+
+IntersectionFinder::IntersectionFinder() : m_ownArena(new std::pmr::unsynchronized_pool_resource), m_resource(m_ownArena.get()) 
+{
+}
+
+IntersectionFinder::IntersectionFinder(std::pmr::memory_resource* resource) : m_resource(resource) 
+{
+}
+
+void IntersectionFinder::loadRectanglesFromFile(const std::string& filename, size_t max_rectangles) 
+{
+    loadRectangles(Rectangle::loadFromFile(filename, max_rectangles));
+}
+
+void IntersectionFinder::loadRectanglesFromStream(std::istream& input, size_t max_rectangles, std::ostream& info) 
+{
+    loadRectangles(Rectangle::loadFromStream(input, max_rectangles, info));
+}
+
+void IntersectionFinder::loadRectangles(std::vector<Rectangle>&& rectangles) 
+{
+    m_inputRectangles = std::move(rectangles);
+    clearResults();
+    m_raster.reset();
+    m_index.clear();
+    m_indexBuilt = false;
+    m_nextId = 1;
+
+    for (const auto& rect : m_inputRectangles) 
+    {
+        m_nextId = std::max(m_nextId, rect.id() + 1);
+    }
+    
+    if (m_inputRectangles.size() < 2) 
+    {
+        throw std::runtime_error("Not Possible to find intersections with only one valid rectangle.");
+    }
+}
+
+void IntersectionFinder::clearResults() 
+{
+    /* clear() keeps the capacity, so a finder reused across scenes stops allocating once warm */
+    m_intersections.clear();
+    m_groupsById.clear();
+    m_groupsIndexed = false;
+}
+
+/* Creates a unique sorted key for a group of rectangles */
+std::string IntersectionFinder::createKey(const std::pmr::vector<int>& ids) 
+{
+    std::vector<int> sorted(ids.begin(), ids.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string key = std::to_string(sorted[0]);
+
+    for (size_t i = 1; i < sorted.size(); ++i) 
+    { 
+        key += "-";
+        key += std::to_string(sorted[i]);
+    }
+    
+    return key;
+}
+
+bool IntersectionFinder::recordIntersectionIfUnique(const Rectangle& rect, std::pmr::vector<int>&& parent_ids) 
+{
+    bool boReturn = false;
+
+    std::string key = createKey(parent_ids);
+
+    if (std::find(m_processedKeys.begin(), m_processedKeys.end(), key) == m_processedKeys.end()) 
+    {
+        m_processedKeys.push_back(key);
+        m_intersections.push_back({rect, std::move(parent_ids)});
+
+        boReturn = true;
+    }
+
+    return boReturn;
+}
+
+void IntersectionFinder::recordIntersection(const Rectangle& rect, const std::vector<int>& parent_ids) 
+{
+    m_intersections.push_back({rect, std::pmr::vector<int>(parent_ids.begin(), parent_ids.end(), m_resource)});
+}
+
+void IntersectionFinder::restoreIntersections(std::vector<IntersectionResult>&& results) 
+{
+    m_groupsIndexed = false;
+    m_intersections = std::move(results);
+}
+
+void IntersectionFinder::processIntersections(ThreadPool* pool) 
+{
+    TRACE_SCOPE("enumerate");
+    STATS_PHASE(StatsPhase::Pairwise);
+
+    /* Earlier results go back to the resource, where the new ones reuse them */
+    clearResults();
+
+    if (!enumerateSmallScene<SUBSET_ENGINE_MAX_SIZE>()) 
+    {
+        searchComponents(pool);
+    }
+}
+
+template <size_t N>
+bool IntersectionFinder::enumerateSmallScene() 
+{
+    bool boReturn = false;
+
+    if (m_inputRectangles.size() == N) 
+    {
+        SubsetEngine<N>::enumerate(m_inputRectangles.data(), [this](const Rectangle& region, const int* ids, size_t count) {
+            STATS_DEPTH(count);
+            m_intersections.push_back({region, std::pmr::vector<int>(ids, ids + count, m_resource)});
+        });
+        boReturn = true;
+    }
+    else if constexpr (N > 2) 
+    {
+        boReturn = enumerateSmallScene<N - 1>();
+    }
+
+    return boReturn;
+}
+
+void IntersectionFinder::searchComponents(ThreadPool* pool) 
+{
+    const size_t count = m_inputRectangles.size();
+    m_components.reset(count);
+
+    for (size_t i = 0; i < count; ++i) 
+    {
+        for (size_t j = i + 1; j < count; ++j) 
+        {
+            const auto& r1 = m_inputRectangles[i];
+            const auto& r2 = m_inputRectangles[j];
+
+            Rectangle intersection(-1, 0, 0, 0, 0);
+            if (Rectangle::calculate_intersection(r1, r2, intersection)) 
+            {
+                m_components.addPair(i, j, intersection);
+            }
+        }
+    }
+    m_components.finish();
+
+    if (pool != nullptr && pool->size() > 1 && m_components.componentCount() > 1) 
+    {
+        searchComponentsInParallel(*pool);
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) 
+    {
+        searchGroupsFrom(i, m_search, [this](const Rectangle& region, const std::vector<int>& ids) {
+            recordIntersection(region, ids);
+        });
+    }
+}
+
+template <typename Record>
+void IntersectionFinder::searchGroupsFrom(size_t first, SearchState& state, Record&& record) const 
+{
+    const size_t component = m_components.componentOf(first);
+    const size_t* members = m_components.members(component);
+    const size_t size = m_components.componentSize(component);
+
+    /* A group holds at most every member: one frame per member past the pair */
+    state.frames.reserve(size);
+    state.path.reserve(size);
+
+    for (const auto* pair = m_components.pairsBegin(first); pair != m_components.pairsEnd(first); ++pair) 
+    {
+        STATS_PHASE(StatsPhase::Recursion);
+        STATS_DEPTH(2);
+
+        state.path.assign({m_inputRectangles[first].id(), m_inputRectangles[pair->second].id()});
+        record(pair->region, state.path);
+
+        state.frames.clear();
+        state.frames.push_back({pair->region, m_components.positionOf(pair->second) + 1});
+
+        while (!state.frames.empty()) 
+        {
+            EnumerationFrame& top = state.frames.back();
+
+            /* Exhausted: return to the parent group, dropping the rectangle that formed this one */
+            if (top.cursor >= size) 
+            {
+                state.frames.pop_back();
+                if (!state.frames.empty()) 
+                {
+                    state.path.pop_back();
+                }
+                continue;
+            }
+
+            const size_t position = top.cursor++;
+            const auto& next_rect = m_inputRectangles[members[position]];
+            Rectangle new_intersection(-1, 0, 0, 0, 0);
+
+            if (Rectangle::calculate_intersection(top.region, next_rect, new_intersection)) 
+            {
+                state.path.push_back(next_rect.id());
+                record(new_intersection, state.path);
+                STATS_DEPTH(state.path.size());
+                state.frames.push_back({new_intersection, position + 1});
+            }
+        }
+    }
+}
+
+void IntersectionFinder::searchComponentsInParallel(ThreadPool& pool) 
+{
+    /* Groups of one component in search order, kept by the worker until they are stored */
+    struct ComponentGroups 
+    {
+        std::vector<Rectangle> regions;
+        std::vector<int> ids;
+        std::vector<size_t> ends;   /* End of each group's IDs in 'ids' */
+    };
+
+    const size_t count = m_inputRectangles.size();
+    std::vector<size_t> tasks;
+    for (size_t c = 0; c < m_components.componentCount(); ++c) 
+    {
+        if (m_components.componentSize(c) > 1) 
+        {
+            tasks.push_back(c);
+        }
+    }
+
+    /* Largest components first, so the longest searches do not start last */
+    std::stable_sort(tasks.begin(), tasks.end(), [this](size_t a, size_t b) {
+        return m_components.componentSize(a) > m_components.componentSize(b);
+    });
+
+    std::vector<ComponentGroups> found(m_components.componentCount());
+    std::vector<size_t> groups_from(count, 0);     /* Number of groups whose lowest index is each rectangle */
+    std::vector<SearchState> states(pool.size());
+
+    pool.parallelFor(tasks.size(), [&](size_t task, size_t worker) {
+        const size_t component = tasks[task];
+        const size_t* members = m_components.members(component);
+        ComponentGroups& groups = found[component];
+
+        for (size_t k = 0; k < m_components.componentSize(component); ++k) 
+        {
+            const size_t before = groups.regions.size();
+            searchGroupsFrom(members[k], states[worker], [&groups](const Rectangle& region, const std::vector<int>& ids) {
+                groups.regions.push_back(region);
+                groups.ids.insert(groups.ids.end(), ids.begin(), ids.end());
+                groups.ends.push_back(groups.ids.size());
+            });
+            groups_from[members[k]] = groups.regions.size() - before;
+        }
+    });
+
+    /* Serial order is by lowest index: each rectangle takes its groups from where its component stopped */
+    size_t total = 0;
+    for (const auto& groups : found) 
+    {
+        total += groups.regions.size();
+    }
+    m_intersections.reserve(total);
+
+    std::vector<size_t> next(found.size(), 0);
+    for (size_t i = 0; i < count; ++i) 
+    {
+        const size_t component = m_components.componentOf(i);
+        const ComponentGroups& groups = found[component];
+
+        for (size_t g = next[component]; g < next[component] + groups_from[i]; ++g) 
+        {
+            const int* ids = groups.ids.data();
+            m_intersections.push_back({groups.regions[g],
+                                       std::pmr::vector<int>(ids + (g == 0 ? 0 : groups.ends[g - 1]), ids + groups.ends[g], m_resource)});
+        }
+        next[component] += groups_from[i];
+    }
+}
+
+void IntersectionFinder::processMaximalIntersections() 
+{
+    TRACE_SCOPE("maximal");
+    STATS_PHASE(StatsPhase::Maximal);
+
+    /* Earlier results, of any mode, would otherwise stay among the maximal groups */
+    clearResults();
+
+    const size_t count = m_inputRectangles.size();
+    std::vector<std::vector<size_t>> neighbours(count);
+
+    /* Build the overlap graph; lists come out sorted because j grows monotonically */
+    for (size_t i = 0; i < count; ++i) 
+    {
+        for (size_t j = i + 1; j < count; ++j) 
+        {
+            Rectangle intersection(-1, 0, 0, 0, 0);
+            if (Rectangle::calculate_intersection(m_inputRectangles[i], m_inputRectangles[j], intersection)) 
+            {
+                neighbours[i].push_back(j);
+                neighbours[j].push_back(i);
+            }
+        }
+    }
+
+    std::vector<size_t> clique;
+    std::vector<size_t> candidates(count);
+    for (size_t i = 0; i < count; ++i) 
+    {
+        candidates[i] = i;
+    }
+
+    find_maximal_groups_recursive(clique, candidates, {}, neighbours);
+}
+
+void IntersectionFinder::find_maximal_groups_recursive(std::vector<size_t>& clique, std::vector<size_t> candidates, std::vector<size_t> excluded, const std::vector<std::vector<size_t>>& neighbours) 
+{
+    if (candidates.empty()) 
+    {
+        /* Maximal clique; single rectangles are not intersections */
+        if (excluded.empty() && clique.size() >= 2) 
+        {
+            Rectangle common = m_inputRectangles[clique[0]];
+            std::pmr::vector<int> parent_ids({common.id()}, m_resource);
+
+            for (size_t k = 1; k < clique.size(); ++k) 
+            {
+                const auto& next_rect = m_inputRectangles[clique[k]];
+                Rectangle::calculate_intersection(common, next_rect, common);
+                parent_ids.push_back(next_rect.id());
+            }
+
+            /* Bron-Kerbosch reports every maximal clique once, so no key lookup is needed */
+            std::sort(parent_ids.begin(), parent_ids.end());
+            m_intersections.push_back({common, std::move(parent_ids)});
+        }
+        return;
+    }
+
+    /* Pivot on the vertex covering most candidates to prune non-maximal branches */
+    size_t pivot = candidates[0];
+    size_t best_cover = 0;
+    for (const auto* pool : {&candidates, &excluded}) 
+    {
+        for (size_t u : *pool) 
+        {
+            std::vector<size_t> covered;
+            std::set_intersection(candidates.begin(), candidates.end(),
+                                  neighbours[u].begin(), neighbours[u].end(),
+                                  std::back_inserter(covered));
+            if (covered.size() >= best_cover) 
+            {
+                best_cover = covered.size();
+                pivot = u;
+            }
+        }
+    }
+
+    std::vector<size_t> branches;
+    std::set_difference(candidates.begin(), candidates.end(),
+                        neighbours[pivot].begin(), neighbours[pivot].end(),
+                        std::back_inserter(branches));
+
+    for (size_t v : branches) 
+    {
+        std::vector<size_t> next_candidates;
+        std::vector<size_t> next_excluded;
+        std::set_intersection(candidates.begin(), candidates.end(),
+                              neighbours[v].begin(), neighbours[v].end(),
+                              std::back_inserter(next_candidates));
+        std::set_intersection(excluded.begin(), excluded.end(),
+                              neighbours[v].begin(), neighbours[v].end(),
+                              std::back_inserter(next_excluded));
+
+        clique.push_back(v);
+        find_maximal_groups_recursive(clique, next_candidates, next_excluded, neighbours);
+        clique.pop_back();
+
+        /* Move v from candidates to excluded, keeping both sorted */
+        candidates.erase(std::lower_bound(candidates.begin(), candidates.end(), v));
+        excluded.insert(std::lower_bound(excluded.begin(), excluded.end(), v), v);
+    }
+}
+
+void IntersectionFinder::processArrangementCells() 
+{
+    TRACE_SCOPE("cells");
+    STATS_PHASE(StatsPhase::Cells);
+    m_groupsIndexed = false;
+    m_intersections = ArrangementEngine::buildCells(m_inputRectangles, m_resource);
+}
+
+uint64_t IntersectionFinder::countOverlappingPairs() const 
+{
+    TRACE_SCOPE("count pairs");
+    STATS_PHASE(StatsPhase::Counting);
+    return OverlapCounter::countOverlappingPairs(m_inputRectangles);
+}
+
+std::vector<BigUnsigned> IntersectionFinder::countIntersectionsByOrder() const 
+{
+    TRACE_SCOPE("count orders");
+    STATS_PHASE(StatsPhase::Counting);
+    return OrderCounter::countByOrder(m_inputRectangles);
+}
+
+void IntersectionFinder::buildIndex() 
+{
+    if (!m_indexBuilt) 
+    {
+        TRACE_SCOPE("index build");
+        m_index.clear();
+        for (const auto& rect : m_inputRectangles) 
+        {
+            m_index.insert(rect);
+        }
+        m_indexBuilt = true;
+    }
+}
+
+void IntersectionFinder::ensureGroupIndex() 
+{
+    if (!m_groupsIndexed) 
+    {
+        m_groupsById.clear();
+        for (size_t index = 0; index < m_intersections.size(); ++index) 
+        {
+            for (int id : m_intersections[index].parent_ids) 
+            {
+                m_groupsById[id].push_back(index);
+            }
+        }
+        m_groupsIndexed = true;
+    }
+}
+
+void IntersectionFinder::appendGroup(const IntersectionResult& group) 
+{
+    if (m_groupsIndexed) 
+    {
+        for (int id : group.parent_ids) 
+        {
+            m_groupsById[id].push_back(m_intersections.size());
+        }
+    }
+
+    m_intersections.push_back({group.rect, std::pmr::vector<int>(group.parent_ids, m_resource)});
+}
+
+void IntersectionFinder::removeGroup(size_t index) 
+{
+    const size_t last = m_intersections.size() - 1;
+
+    for (int id : m_intersections[index].parent_ids) 
+    {
+        auto& groups = m_groupsById[id];
+        groups.erase(std::find(groups.begin(), groups.end(), index));
+        if (groups.empty()) 
+        {
+            m_groupsById.erase(id);
+        }
+    }
+
+    /* Swap-and-pop: the last group takes the freed slot, so its reverse entries are renumbered */
+    if (index != last) 
+    {
+        for (int id : m_intersections[last].parent_ids) 
+        {
+            auto& groups = m_groupsById[id];
+            *std::find(groups.begin(), groups.end(), last) = index;
+        }
+        m_intersections[index] = std::move(m_intersections[last]);
+    }
+
+    m_intersections.pop_back();
+}
+
+void IntersectionFinder::removeGroupsOf(int id) 
+{
+    ensureGroupIndex();
+
+    auto found = m_groupsById.find(id);
+    if (found == m_groupsById.end()) 
+    {
+        return;
+    }
+
+    /* Highest slots first, so swap-and-pop never moves a group that is still to be removed */
+    std::vector<size_t> indices = found->second;
+    std::sort(indices.rbegin(), indices.rend());
+    for (size_t index : indices) 
+    {
+        removeGroup(index);
+    }
+}
+
+void IntersectionFinder::addGroupsOf(const Rectangle& rect, std::vector<IntersectionResult>& new_groups) 
+{
+    std::vector<Rectangle> neighbours;
+    for (int id : m_index.query(rect)) 
+    {
+        neighbours.push_back(*m_index.find(id));
+    }
+
+    new_groups.clear();
+    std::vector<int> parent_ids;
+    find_insertion_groups_recursive(rect, parent_ids, neighbours, 0, rect.id(), new_groups);
+
+    for (const auto& group : new_groups) 
+    {
+        appendGroup(group);
+    }
+}
+
+std::vector<int> IntersectionFinder::queryWindow(const Rectangle& window) 
+{
+    buildIndex();
+    return m_index.query(window);
+}
+
+std::vector<int> IntersectionFinder::queryPoint(int x, int y) 
+{
+    buildIndex();
+    return m_index.query(Rectangle(-1, x, y, 1, 1));
+}
+
+int IntersectionFinder::insert(const Rectangle& rect, std::vector<IntersectionResult>& new_groups) 
+{
+    if (rect.w() <= 0 || rect.h() <= 0) 
+    {
+        throw std::invalid_argument("Inserted rectangle must have positive width and height.");
+    }
+    if (int64_t(rect.x()) + rect.w() > INT_MAX || int64_t(rect.y()) + rect.h() > INT_MAX) 
+    {
+        throw std::invalid_argument("Inserted rectangle must end within the int range.");
+    }
+
+    buildIndex();
+
+    const Rectangle added(m_nextId++, rect.x(), rect.y(), rect.w(), rect.h());
+
+    addGroupsOf(added, new_groups);
+
+    m_inputRectangles.push_back(added);
+    m_index.insert(added);
+    m_raster.reset();
+
+    return added.id();
+}
+
+bool IntersectionFinder::erase(int id) 
+{
+    bool boReturn = false;
+
+    buildIndex();
+
+    if (m_index.erase(id)) 
+    {
+        removeGroupsOf(id);
+
+        m_inputRectangles.erase(std::find_if(m_inputRectangles.begin(), m_inputRectangles.end(), [id](const Rectangle& rect) {
+            return rect.id() == id;
+        }));
+        m_raster.reset();
+
+        boReturn = true;
+    }
+
+    return boReturn;
+}
+
+bool IntersectionFinder::move(int id, const Rectangle& rect, std::vector<IntersectionResult>& new_groups) 
+{
+    bool boReturn = false;
+
+    if (rect.w() <= 0 || rect.h() <= 0) 
+    {
+        throw std::invalid_argument("Moved rectangle must have positive width and height.");
+    }
+    if (int64_t(rect.x()) + rect.w() > INT_MAX || int64_t(rect.y()) + rect.h() > INT_MAX) 
+    {
+        throw std::invalid_argument("Moved rectangle must end within the int range.");
+    }
+
+    buildIndex();
+
+    if (m_index.erase(id)) 
+    {
+        removeGroupsOf(id);
+
+        const Rectangle moved(id, rect.x(), rect.y(), rect.w(), rect.h());
+        addGroupsOf(moved, new_groups);
+
+        /* Keep the rectangle's position in the input order */
+        *std::find_if(m_inputRectangles.begin(), m_inputRectangles.end(), [id](const Rectangle& input) {
+            return input.id() == id;
+        }) = moved;
+        m_index.insert(moved);
+        m_raster.reset();
+
+        boReturn = true;
+    }
+
+    return boReturn;
+}
+
+void IntersectionFinder::find_insertion_groups_recursive(const Rectangle& current_intersection, std::vector<int>& parent_ids, const std::vector<Rectangle>& neighbours, size_t start_index, int new_id, std::vector<IntersectionResult>& new_groups) 
+{
+    for (size_t i = start_index; i < neighbours.size(); ++i) 
+    {
+        Rectangle new_intersection(-1, 0, 0, 0, 0);
+
+        if (Rectangle::calculate_intersection(current_intersection, neighbours[i], new_intersection)) 
+        {
+            parent_ids.push_back(neighbours[i].id());
+
+            /* Neighbours come sorted by ID; slot the new ID in to keep the group ascending */
+            std::pmr::vector<int> group_ids(parent_ids.begin(), parent_ids.end());
+            group_ids.insert(std::lower_bound(group_ids.begin(), group_ids.end(), new_id), new_id);
+            new_groups.push_back({new_intersection, std::move(group_ids)});
+
+            find_insertion_groups_recursive(new_intersection, parent_ids, neighbours, i + 1, new_id, new_groups);
+            parent_ids.pop_back();
+        }
+    }
+}
+
+const RasterCoverage* IntersectionFinder::raster() const 
+{
+    if (!m_raster && RasterCoverage::isSuitable(m_inputRectangles)) 
+    {
+        m_raster = std::make_shared<const RasterCoverage>(m_inputRectangles);
+    }
+
+    return m_raster.get();
+}
+
+IntersectionResult IntersectionFinder::findMaxDepth() const 
+{
+    TRACE_SCOPE("max depth");
+    STATS_PHASE(StatsPhase::Counting);
+    if (const RasterCoverage* coverage = raster()) 
+    {
+        return coverage->findMaxDepth(m_inputRectangles);
+    }
+
+    return DepthQuery::findMaxDepth(m_inputRectangles);
+}
+
+AreaStats IntersectionFinder::computeAreaStats() const 
+{
+    TRACE_SCOPE("area");
+    STATS_PHASE(StatsPhase::Counting);
+    if (const RasterCoverage* coverage = raster()) 
+    {
+        return coverage->computeAreaStats();
+    }
+
+    return AreaCalculator::computeAreaStats(m_inputRectangles);
+}
+
+int IntersectionFinder::depthAt(int x, int y) const 
+{
+    if (const RasterCoverage* coverage = raster()) 
+    {
+        return coverage->depthAt(x, y);
+    }
+
+    int depth = 0;
+    for (const auto& rect : m_inputRectangles) 
+    {
+        if (rect.x() <= x && x < rect.right() && rect.y() <= y && y < rect.bottom()) 
+        {
+            ++depth;
+        }
+    }
+    return depth;
+}
+
+void IntersectionFinder::printResults(std::ostream& out) 
+{
+    TRACE_SCOPE("output");
+    STATS_PHASE(StatsPhase::Print);
+    out << "Input:\n";
+    for (const auto& rect : m_inputRectangles) 
+    {
+        out << "\t" << rect.id() << ": Rectangle at ("
+                  << rect.x() << "," << rect.y() << "), "
+                  << "w=" << rect.w() << ", h=" << rect.h() << ".\n";
+    }
+
+    out << "Intersections:\n";
+
+    if (m_intersections.empty()) 
+    {
+        out << "No intersections found.\n";
+        return;
+    }
+
+    std::vector<IntersectionResult> sorted; 
+    {
+        STATS_PHASE(StatsPhase::Sort);
+        sorted = m_intersections;
+
+        std::sort(sorted.begin(), sorted.end(), [](const IntersectionResult& a, const IntersectionResult& b) {
+        /* First: by number of rectangles involved (ascending) */
+        if (a.parent_ids.size() != b.parent_ids.size()) 
+        {
+            return a.parent_ids.size() < b.parent_ids.size();
+        }
+
+        /* Second: by the smallest rectangle ID in the intersection */
+        auto sorted_a = a.parent_ids, sorted_b = b.parent_ids;
+        std::sort(sorted_a.begin(), sorted_a.end());
+        std::sort(sorted_b.begin(), sorted_b.end());
+
+        if (sorted_a != sorted_b) 
+        {
+            return sorted_a < sorted_b;
+        }
+
+        /* Third: by position, for disjoint regions sharing the same rectangles (arrangement cells) */
+        if (a.rect.y() != b.rect.y()) 
+        {
+            return a.rect.y() < b.rect.y();
+        }
+        return a.rect.x() < b.rect.x();
+        });
+    }
+
+    for (size_t i = 0; i < sorted.size(); ++i) 
+    {
+        printResult(out, sorted[i]);
+    }
+}
+    
+void IntersectionFinder::printResult(std::ostream& out, const IntersectionResult& result) 
+{
+    const auto& rect = result.rect;
+
+    if (result.parent_ids.size() == 1) 
+    {
+        out << "\tOnly rectangle " << result.parent_ids[0] << " at (" << rect.x() << "," << rect.y()
+            << "), w=" << rect.w() << ", h=" << rect.h() << ".\n";
+        return;
+    }
+
+    out << "\tBetween rectangle ";
+
+    for (size_t j = 0; j < result.parent_ids.size(); ++j) 
+    {
+        out << result.parent_ids[j];
+        if (j + 2 == result.parent_ids.size()) 
+        {
+            out << " and ";
+        } 
+        else if (j + 1 < result.parent_ids.size()) 
+        {
+            out << ", ";
+        }
+    }
+
+    out << " at (" << rect.x() << "," << rect.y()
+        << "), w=" << rect.w() << ", h=" << rect.h() << ".\n";
+}
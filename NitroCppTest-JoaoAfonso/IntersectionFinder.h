@@ -1,103 +1,461 @@
-#ifndef INTERSECTION_FINDER_HPP
-#define INTERSECTION_FINDER_HPP
-
-#include <vector>
-#include <string>
-#include "Rectangle.h"
-
-
-/**
-* @struct IntersectionResult
-* @brief Stores the result of a rectangle intersection.
-*
-* Contains the resulting intersected rectangle and the IDs of the rectangles involved.
-*/
-struct IntersectionResult 
-{
-    Rectangle rect;               /* The intersected rectangle */
-    std::vector<int> parent_ids;  /* The original rectangles involved in the intersection */
-};
-
-/**
-* @class IntersectionFinder
-* @brief Orchestrates loading rectangles, finding intersections, and reporting results.
-*
-* This class encapsulates:
-* - Reading input rectangles from a JSON file
-* - Performing 2-way and recursive N-way intersection detection
-* - Storing and printing the results
-*/
-class IntersectionFinder 
-{
-private:
-    std::vector<Rectangle> m_inputRectangles;     /* Rectangles loaded from input */
-    std::vector<IntersectionResult> m_intersections; /* Detected intersections */
-    std::vector<std::string> m_processedKeys;   /* Used to track processed intersection keys (unused currently, reserved for deduplication). */
-
-    /**
-    * @brief Recursively detects intersections involving 3 or more rectangles.
-    * @param current_intersection The current intersected rectangle.
-    * @param parent_ids IDs of rectangles involved so far.
-    * @param start_index Index to continue iteration from.
-    */
-    void find_intersections_recursive(
-        const Rectangle& current_intersection,
-        const std::vector<int>& parent_ids,
-        size_t start_index
-    );
-
-    /**
-    * @brief Generates a sorted string key from rectangle IDs.
-    * 
-    * Used for identification or deduplication of intersection groups.
-    *
-    * @param ids Vector of rectangle IDs involved in an intersection.
-    * @return std::string A hyphen-separated, sorted string representation of the IDs.
-    */
-    std::string createKey(const std::vector<int>& ids);
-
-    /**
-    * @brief Records an intersection if its key has not been seen before.
-    * 
-    * @param rect The intersected rectangle.
-    * @param parent_ids The IDs of rectangles that form this intersection.
-    * @return true if this is a new (unique) intersection and it was recorded.
-    * @return false if this intersection was already recorded.
-    */
-    bool recordIntersectionIfUnique(const Rectangle& rect, const std::vector<int>& parent_ids);
-
-public:
-    /**
-    * @brief Constructs an IntersectionFinder instance.
-    */
-    IntersectionFinder();
-
-    /**
-    * @brief Loads rectangles from a JSON file.
-    * 
-    * Reads and parses rectangles from a JSON input file. Validates format and field presence.
-    * 
-    * @param filename Path to the JSON input file.
-    * @throws std::runtime_error if the file is missing, invalid, or contains malformed rectangles.
-    */
-    void loadRectanglesFromFile(const std::string& filename);
-
-    /**
-    * @brief Computes all pairwise and higher-order intersections.
-    * 
-    * Iteratively compares rectangles to find intersections, including recursive intersections involving
-    * three or more rectangles.
-    */
-    void processIntersections();
-
-    /**
-    * @brief Prints the original rectangles and all found intersections to stdout.
-    * 
-    * Outputs a formatted list of input rectangles followed by detailed intersection results,
-    * indicating which rectangles contributed to each intersection.
-    */
-    void printResults();
-};
-
-#endif // INTERSECTION_FINDER_HPP
-
+#ifndef INTERSECTION_FINDER_HPP
+#define INTERSECTION_FINDER_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include <istream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include "Rectangle.h"
+#include "BigUnsigned.h"
+#include "AreaCalculator.h"
+#include "SpatialGrid.h"
+#include "OverlapComponents.h"
+
+
+class RasterCoverage;
+class ThreadPool;
+
+/**
+* @struct IntersectionResult
+* @brief Stores the result of a rectangle intersection.
+*
+* Contains the resulting intersected rectangle and the IDs of the rectangles involved.
+* Results stored by an IntersectionFinder take their IDs from the finder's memory resource;
+* copies made outside it use the default resource.
+*/
+struct IntersectionResult 
+{
+    Rectangle rect;                    /* The intersected rectangle */
+    std::pmr::vector<int> parent_ids;  /* The original rectangles involved in the intersection */
+};
+
+/**
+* @class IntersectionFinder
+* @brief Orchestrates loading rectangles, finding intersections, and reporting results.
+*
+* This class encapsulates:
+* - Reading input rectangles from a JSON file
+* - Performing 2-way and N-way intersection detection
+* - Storing and printing the results
+*/
+class IntersectionFinder 
+{
+private:
+    /**
+    * @struct EnumerationFrame
+    * @brief One level of the enumeration stack: the common region of a group and the position,
+    * among the members of its component, of the next rectangle to try adding to it.
+    */
+    struct EnumerationFrame 
+    {
+        Rectangle region;
+        size_t cursor;
+    };
+
+    /**
+    * @struct SearchState
+    * @brief Explicit stack and ID path of one enumerating thread, kept across runs.
+    */
+    struct SearchState 
+    {
+        std::vector<EnumerationFrame> frames;
+        std::vector<int> path;      /* IDs of the group on top of 'frames' */
+    };
+
+    std::vector<Rectangle> m_inputRectangles;     /* Rectangles loaded from input */
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> m_ownArena; /* Backs the results unless the caller supplied a resource. */
+    std::pmr::memory_resource* m_resource;        /* Holds the IDs of m_intersections; freed IDs are reused by the next results. */
+    std::vector<IntersectionResult> m_intersections; /* Detected intersections */
+    std::vector<std::string> m_processedKeys;   /* Keys of the groups recorded through recordIntersectionIfUnique(). */
+    mutable std::shared_ptr<const RasterCoverage> m_raster; /* Coverage raster, built on first use when the bounding box is small. */
+    SpatialGrid m_index;                        /* Dynamic index over m_inputRectangles, built on first incremental update. */
+    bool m_indexBuilt = false;                  /* True once m_index mirrors m_inputRectangles. */
+    int m_nextId = 1;                           /* ID assigned to the next inserted rectangle. */
+    std::unordered_map<int, std::vector<size_t>> m_groupsById; /* Rectangle ID -> positions in m_intersections of the groups containing it. */
+    bool m_groupsIndexed = false;               /* True once m_groupsById mirrors m_intersections. */
+    OverlapComponents m_components;             /* Overlapping pairs and components found by the last pairwise pass. */
+    SearchState m_search;                       /* Enumeration state of a serial processIntersections(). */
+
+    /**
+    * @brief Builds the ID -> group reverse index over m_intersections if it is not current.
+    */
+    void ensureGroupIndex();
+
+    /**
+    * @brief Appends a group to the stored results, keeping the reverse index current.
+    * @param group The group to store.
+    */
+    void appendGroup(const IntersectionResult& group);
+
+    /**
+    * @brief Removes the stored group at a position by swapping the last group into its slot.
+    * @param index Position in m_intersections.
+    */
+    void removeGroup(size_t index);
+
+    /**
+    * @brief Removes every stored group containing a rectangle, found through the reverse index.
+    * @param id ID of the rectangle.
+    */
+    void removeGroupsOf(int id);
+
+    /**
+    * @brief Enumerates and stores the groups a rectangle forms with its indexed neighbours.
+    * @param rect The rectangle, which must not itself be in m_index.
+    * @param new_groups Receives the groups found.
+    */
+    void addGroupsOf(const Rectangle& rect, std::vector<IntersectionResult>& new_groups);
+
+    /**
+    * @brief Enumerates the groups formed by a new rectangle and subsets of its neighbours.
+    * @param current_intersection Common region of the new rectangle and the neighbours chosen so far.
+    * @param parent_ids IDs of the neighbours chosen so far (ascending); the new ID is merged in when recording.
+    * @param neighbours Rectangles overlapping the new rectangle, by ascending ID.
+    * @param start_index Index in 'neighbours' to continue iteration from.
+    * @param new_id ID of the inserted or moved rectangle.
+    * @param new_groups Receives every group found.
+    */
+    void find_insertion_groups_recursive(
+        const Rectangle& current_intersection,
+        std::vector<int>& parent_ids,
+        const std::vector<Rectangle>& neighbours,
+        size_t start_index,
+        int new_id,
+        std::vector<IntersectionResult>& new_groups
+    );
+
+    /**
+    * @brief Returns the coverage raster if the input suits the raster engine, building it on first use.
+    * @return const RasterCoverage* The raster, or nullptr when the sweep engines should be used.
+    */
+    const RasterCoverage* raster() const;
+
+    /**
+    * @brief Enumerates the scene with SubsetEngine<count> when it holds 2 to N rectangles.
+    * @return true if the scene was enumerated; false leaves it to searchComponents().
+    */
+    template <size_t N>
+    bool enumerateSmallScene();
+
+    /**
+    * @brief Enumerates the scene through the pairwise pass and a search of each overlap component.
+    * @param pool Pool searching the components, or nullptr.
+    */
+    void searchComponents(ThreadPool* pool);
+
+    /**
+    * @brief Finds every group whose lowest-index rectangle is 'first', from the last pairwise pass.
+    *
+    * Each overlapping pair (first, j) is reported, then extended by the later members of their
+    * component only. The search runs depth first over an explicit stack of frames instead of
+    * recursion: a group is reported, then every extension of it, before its next sibling, which is
+    * the order of the former recursive search. Groups are extended in index order only, so every
+    * group is visited once and needs no key lookup. Once 'state' has grown to the component size,
+    * no step allocates, and the depth is not bounded by the call stack.
+    *
+    * @param first Index of the rectangle.
+    * @param state Stack and ID path of the calling thread.
+    * @param record Called as record(region, ids) for every group, 'ids' being a std::vector<int>.
+    */
+    template <typename Record>
+    void searchGroupsFrom(size_t first, SearchState& state, Record&& record) const;
+
+    /**
+    * @brief Finds the groups of every component with a pool and stores them in serial order.
+    * @param pool Pool running one component per task.
+    */
+    void searchComponentsInParallel(ThreadPool& pool);
+
+    /**
+    * @brief Stores a group, copying its IDs into the memory resource.
+    * @param rect The intersected rectangle.
+    * @param parent_ids The IDs of rectangles that form this intersection.
+    */
+    void recordIntersection(const Rectangle& rect, const std::vector<int>& parent_ids);
+
+    /**
+    * @brief Generates a sorted string key from rectangle IDs.
+    * 
+    * Used for identification or deduplication of intersection groups.
+    *
+    * @param ids Vector of rectangle IDs involved in an intersection.
+    * @return std::string A hyphen-separated, sorted string representation of the IDs.
+    */
+    std::string createKey(const std::pmr::vector<int>& ids);
+
+    /**
+    * @brief Records an intersection if its key has not been seen before.
+    * 
+    * @param rect The intersected rectangle.
+    * @param parent_ids The IDs of rectangles that form this intersection, moved into the results.
+    * @return true if this is a new (unique) intersection and it was recorded.
+    * @return false if this intersection was already recorded.
+    */
+    bool recordIntersectionIfUnique(const Rectangle& rect, std::pmr::vector<int>&& parent_ids);
+
+    /**
+    * @brief Bron-Kerbosch search (with pivoting) for maximal cliques of the overlap graph.
+    *
+    * Axis-aligned rectangles have the Helly property: if every pair of a group overlaps,
+    * the whole group shares a common region. Maximal cliques are therefore exactly the
+    * inclusion-maximal overlapping groups.
+    *
+    * @param clique Indices of the rectangles in the current clique.
+    * @param candidates Indices that can still extend the clique (sorted).
+    * @param excluded Indices already processed at this level (sorted).
+    * @param neighbours Sorted adjacency lists of the overlap graph, by rectangle index.
+    */
+    void find_maximal_groups_recursive(
+        std::vector<size_t>& clique,
+        std::vector<size_t> candidates,
+        std::vector<size_t> excluded,
+        const std::vector<std::vector<size_t>>& neighbours
+    );
+
+public:
+    /**
+    * @brief Constructs an IntersectionFinder instance whose results live in a pool it owns.
+    */
+    IntersectionFinder();
+
+    /**
+    * @brief Constructs an IntersectionFinder instance whose results live in a caller-supplied resource.
+    *
+    * Every stored result takes its IDs from 'resource', which must outlive them. With a
+    * std::pmr::monotonic_buffer_resource per scene, calling clearResults() and then release()
+    * on the resource frees a whole scene at once instead of one vector per result.
+    *
+    * @param resource Memory resource of the results; not owned.
+    */
+    explicit IntersectionFinder(std::pmr::memory_resource* resource);
+
+    inline std::pmr::memory_resource* memoryResource() const { return m_resource; }  /* Returns the resource holding the results. */
+
+    /**
+    * @brief Drops the stored results, keeping the capacity of the result vector.
+    *
+    * Afterwards nothing in the finder refers to memory of its resource, which may be released.
+    */
+    void clearResults();
+
+    /**
+    * @brief Loads rectangles from a JSON file.
+    * 
+    * Reads and parses rectangles from a JSON input file. Validates format and field presence.
+    * 
+    * @param filename Path to the JSON input file.
+    * @param max_rectangles Maximum number of rectangles to load; 0 loads all of them.
+    * @throws std::runtime_error if the file is missing, invalid, or contains malformed rectangles.
+    */
+    void loadRectanglesFromFile(const std::string& filename, size_t max_rectangles = MAX_RECTANGLES);
+
+    /**
+    * @brief Loads rectangles from a JSON document read from a stream.
+    *
+    * Results of a previous scene are discarded, but their storage is kept so that one
+    * finder can be reused across many scenes without reallocating.
+    *
+    * @param input Stream positioned at the JSON document.
+    * @param max_rectangles Maximum number of rectangles to load; 0 loads all of them.
+    * @param info Receives the informational messages about truncated or skipped input.
+    * @throws std::runtime_error if the JSON is invalid or fewer than two rectangles are valid.
+    */
+    void loadRectanglesFromStream(std::istream& input, size_t max_rectangles, std::ostream& info);
+
+    /**
+    * @brief Replaces the input with already parsed rectangles and resets every derived structure.
+    * @param rectangles The new input, with unique positive IDs.
+    * @throws std::runtime_error if fewer than two rectangles are given.
+    */
+    void loadRectangles(std::vector<Rectangle>&& rectangles);
+
+    /**
+    * @brief Replaces the stored results with previously computed ones, e.g. from a result cache.
+    * @param results Groups over the IDs of the loaded rectangles.
+    */
+    void restoreIntersections(std::vector<IntersectionResult>&& results);
+
+    /**
+    * @brief Computes all pairwise and higher-order intersections.
+    * 
+    * Iteratively compares rectangles to find intersections, including recursive intersections involving
+    * three or more rectangles. Replaces the stored results. Once the memory resource and the result
+    * vector are warm, the search performs no heap allocation per result.
+    *
+    * Scenes of 2 to SUBSET_ENGINE_MAX_SIZE rectangles go to SubsetEngine<N>, picked by their count,
+    * which works on the stack. Larger ones go through a pairwise pass, which also finds the
+    * connected components of the overlap graph, and each group is only extended by rectangles of
+    * its own component. With a pool, components are searched concurrently and their groups merged
+    * back into the serial order. Both paths report the same groups in the same order.
+    *
+    * @param pool Pool searching the components of larger scenes; nullptr (the default) searches on the
+    *             calling thread. Must not be called from a task of the same pool.
+    */
+    void processIntersections(ThreadPool* pool = nullptr);
+
+    /**
+    * @brief Computes only the inclusion-maximal overlapping groups.
+    *
+    * A group is reported when all of its rectangles share a common region and no other
+    * rectangle overlaps that whole group. Each group is stored with its common region.
+    * Groups are found directly as maximal cliques of the pairwise overlap graph, so the
+    * 2^m - m - 1 subsets of an m-way cluster are never enumerated.
+    */
+    void processMaximalIntersections();
+
+    /**
+    * @brief Decomposes the covered plane into disjoint cells labelled with their coverage sets.
+    *
+    * Replaces the stored results with the cells built by ArrangementEngine. Every cell is
+    * reported with the IDs of all rectangles covering it, including cells covered by a
+    * single rectangle.
+    */
+    void processArrangementCells();
+
+    /**
+    * @brief Counts the overlapping pairs without materializing any result.
+    *
+    * Runs in O(n log n) via OverlapCounter and leaves the stored results untouched.
+    *
+    * @return uint64_t Number of unordered pairs of rectangles with a non-empty overlap.
+    */
+    uint64_t countOverlappingPairs() const;
+
+    /**
+    * @brief Counts the intersecting groups of each size without enumerating them.
+    *
+    * Uses OrderCounter, so the cost is polynomial even when processIntersections() would
+    * report exponentially many groups. Useful to predict output size before enumerating.
+    *
+    * @return std::vector<BigUnsigned> Entry k holds the number of k-rectangle groups with a
+    *         non-empty common region (see OrderCounter::countByOrder).
+    */
+    std::vector<BigUnsigned> countIntersectionsByOrder() const;
+
+    /**
+    * @brief Finds the largest number of rectangles stacked on a single point.
+    *
+    * Runs in O(n log n) via DepthQuery instead of enumerating every N-way intersection, or as a
+    * linear scan over RasterCoverage when the bounding box is small enough.
+    *
+    * @return IntersectionResult A witness region in 'rect' and the IDs covering it in 'parent_ids';
+    *         the depth is parent_ids.size().
+    */
+    IntersectionResult findMaxDepth() const;
+
+    /**
+    * @brief Computes the union area and the area covered by exactly k rectangles, for every k.
+    *
+    * Runs a coverage sweep via AreaCalculator instead of applying inclusion-exclusion
+    * to the enumerated intersections, or counts RasterCoverage cells when the bounding
+    * box is small enough.
+    *
+    * @return AreaStats The union area and the per-depth areas.
+    */
+    AreaStats computeAreaStats() const;
+
+    /**
+    * @brief Stabbing query: counts the rectangles covering the unit cell at (x, y).
+    *
+    * O(1) when the raster engine applies, otherwise a linear scan of the input.
+    *
+    * @param x X-coordinate of the cell.
+    * @param y Y-coordinate of the cell.
+    * @return int Number of rectangles covering the cell.
+    */
+    int depthAt(int x, int y) const;
+
+    /**
+    * @brief Builds the spatial index over the loaded rectangles if it is not current.
+    *
+    * Called implicitly by the incremental updates and the window and point queries;
+    * long-lived callers can call it up front so that the first query is served warm.
+    */
+    void buildIndex();
+
+    /**
+    * @brief Window query: IDs of the rectangles sharing a region of positive area with a window.
+    * @param window Query rectangle.
+    * @return std::vector<int> Matching IDs in ascending order.
+    */
+    std::vector<int> queryWindow(const Rectangle& window);
+
+    /**
+    * @brief Stabbing query: IDs of the rectangles covering the unit cell at (x, y).
+    * @param x X-coordinate of the cell.
+    * @param y Y-coordinate of the cell.
+    * @return std::vector<int> Matching IDs in ascending order.
+    */
+    std::vector<int> queryPoint(int x, int y);
+
+    inline const std::vector<Rectangle>& rectangles() const { return m_inputRectangles; }             /* Returns the loaded rectangles. */
+    inline const std::vector<IntersectionResult>& intersections() const { return m_intersections; }  /* Returns the stored results. */
+
+    /**
+    * @brief Adds a rectangle and updates the stored intersections in place.
+    *
+    * The rectangle receives the next free ID (its own ID is ignored). Only its overlapping
+    * neighbours are looked up, through a dynamic SpatialGrid, and only the groups containing
+    * the new rectangle are enumerated, so the cost depends on the neighbourhood rather than
+    * on the scene. The new groups are appended to the stored results, keeping the output of
+    * processIntersections() current.
+    *
+    * @param rect Rectangle to add (positive width and height).
+    * @param new_groups Receives the intersection groups created by the insertion.
+    * @return int The ID assigned to the rectangle.
+    * @throws std::invalid_argument if the rectangle has a non-positive width or height, or its right or
+    *         bottom edge exceeds INT_MAX.
+    */
+    int insert(const Rectangle& rect, std::vector<IntersectionResult>& new_groups);
+
+    /**
+    * @brief Removes a rectangle and every stored group containing it.
+    *
+    * The affected groups are found through an ID -> group reverse index over the stored
+    * results, so no other group is touched.
+    *
+    * @param id ID of the rectangle.
+    * @return true if the rectangle existed and was removed; false otherwise.
+    */
+    bool erase(int id);
+
+    /**
+    * @brief Moves or resizes a rectangle, keeping its ID, and updates the stored groups in place.
+    *
+    * Groups containing the rectangle are invalidated through the reverse index and recomputed
+    * from its new neighbourhood only.
+    *
+    * @param id ID of the rectangle.
+    * @param rect New position and size (its ID is ignored).
+    * @param new_groups Receives the groups the rectangle forms at its new position.
+    * @return true if the rectangle existed and was moved; false otherwise.
+    * @throws std::invalid_argument if the rectangle has a non-positive width or height, or its right or
+    *         bottom edge exceeds INT_MAX.
+    */
+    bool move(int id, const Rectangle& rect, std::vector<IntersectionResult>& new_groups);
+
+    /**
+    * @brief Prints the original rectangles and all found intersections.
+    * 
+    * Outputs a formatted list of input rectangles followed by detailed intersection results,
+    * indicating which rectangles contributed to each intersection.
+    *
+    * @param out Destination stream (stdout by default).
+    */
+    void printResults(std::ostream& out = std::cout);
+
+    /**
+    * @brief Prints a single result in the same format used by printResults().
+    * @param out Destination stream.
+    * @param result The region and the IDs of the rectangles involved.
+    */
+    static void printResult(std::ostream& out, const IntersectionResult& result);
+};
+
+#endif // INTERSECTION_FINDER_HPP
+
@@ -0,0 +1,123 @@
+#include "OrderCounter.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace 
+{
+    /* Strict ordering of left edges, ties broken by input position */
+    inline bool startsBeforeX(const std::vector<Rectangle>& rects, size_t r, size_t a) 
+    {
+        return rects[r].x() < rects[a].x() || (rects[r].x() == rects[a].x() && r < a);
+    }
+
+    /* Strict ordering of top edges, ties broken by input position */
+    inline bool startsBeforeY(const std::vector<Rectangle>& rects, size_t r, size_t b) 
+    {
+        return rects[r].y() < rects[b].y() || (rects[r].y() == rects[b].y() && r < b);
+    }
+}
+
+std::vector<BigUnsigned> OrderCounter::countByOrder(const std::vector<Rectangle>& rectangles) 
+{
+    const size_t count = rectangles.size();
+
+    /* same_corner[m]: corners with a == b and m other eligible members; split_corner[m]: a != b, m others */
+    std::vector<uint64_t> same_corner(count + 1, 0);
+    std::vector<uint64_t> split_corner(count + 1, 0);
+    size_t max_members = 0;
+
+    std::vector<size_t> members;
+    for (size_t a = 0; a < count; ++a) 
+    {
+        const auto& rect_a = rectangles[a];
+        const int corner_x = rect_a.x();
+
+        /* Candidates: a itself and every earlier-starting rectangle overlapping a */
+        members.clear();
+        members.push_back(a);
+        for (size_t r = 0; r < count; ++r) 
+        {
+            const auto& rect_r = rectangles[r];
+            if (r != a && startsBeforeX(rectangles, r, a) && rect_r.right() > corner_x &&
+                rect_r.y() < rect_a.bottom() && rect_a.y() < rect_r.bottom()) 
+            {
+                members.push_back(r);
+            }
+        }
+
+        for (size_t b : members) 
+        {
+            const int corner_y = rectangles[b].y();
+
+            /* a must contain the corner and must not start lower than b */
+            if (b != a && (!startsBeforeY(rectangles, a, b) || rect_a.bottom() <= corner_y)) 
+            {
+                continue;
+            }
+
+            size_t eligible = 0;
+            for (size_t r : members) 
+            {
+                if ((r == b || startsBeforeY(rectangles, r, b)) && rectangles[r].bottom() > corner_y) 
+                {
+                    ++eligible;
+                }
+            }
+
+            size_t free_members = eligible - (a == b ? 1 : 2);
+            (a == b ? same_corner : split_corner)[free_members]++;
+            max_members = std::max(max_members, free_members);
+        }
+    }
+
+    /* counts[k] += same_corner[m] * C(m, k - 1) + split_corner[m] * C(m, k - 2) */
+    std::vector<BigUnsigned> counts(max_members + 3);
+    std::vector<BigUnsigned> binomials;
+
+    for (size_t m = 0; m <= max_members; ++m) 
+    {
+        /* Advance the Pascal row to C(m, 0..m) in place */
+        binomials.push_back(BigUnsigned(1));
+        for (size_t j = m - (m > 0 ? 1 : 0); j > 0; --j) 
+        {
+            binomials[j] += binomials[j - 1];
+        }
+
+        if (same_corner[m] == 0 && split_corner[m] == 0) 
+        {
+            continue;
+        }
+
+        const BigUnsigned same(same_corner[m]);
+        const BigUnsigned split(split_corner[m]);
+        for (size_t j = 0; j <= m; ++j) 
+        {
+            if (!same.isZero()) 
+            {
+                counts[j + 1] += binomials[j] * same;
+            }
+            if (!split.isZero()) 
+            {
+                counts[j + 2] += binomials[j] * split;
+            }
+        }
+    }
+
+    while (!counts.empty() && counts.back().isZero()) 
+    {
+        counts.pop_back();
+    }
+
+    return counts;
+}
+
+BigUnsigned OrderCounter::totalIntersections(const std::vector<BigUnsigned>& counts) 
+{
+    BigUnsigned total;
+    for (size_t k = 2; k < counts.size(); ++k) 
+    {
+        total += counts[k];
+    }
+    return total;
+}
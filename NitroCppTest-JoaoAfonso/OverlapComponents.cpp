@@ -0,0 +1,94 @@
+#include "OverlapComponents.h"
+
+#include <utility>
+
+size_t OverlapComponents::find(size_t index) 
+{
+    while (m_parent[index] != index) 
+    {
+        m_parent[index] = m_parent[m_parent[index]];
+        index = m_parent[index];
+    }
+    return index;
+}
+
+void OverlapComponents::reset(size_t count) 
+{
+    m_parent.resize(count);
+    m_size.assign(count, 1);
+    for (size_t i = 0; i < count; ++i) 
+    {
+        m_parent[i] = i;
+    }
+
+    m_pairs.clear();
+    m_pairBegin.assign(1, 0);
+    m_nextFirst = 0;
+    m_members.clear();
+    m_componentBegin.clear();
+    m_componentOf.clear();
+    m_positionOf.clear();
+}
+
+void OverlapComponents::addPair(size_t first, size_t second, const Rectangle& region) 
+{
+    /* Close the pair lists of the rectangles before 'first' */
+    for (; m_nextFirst < first; ++m_nextFirst) 
+    {
+        m_pairBegin.push_back(m_pairs.size());
+    }
+    m_pairs.push_back({second, region});
+
+    size_t a = find(first);
+    size_t b = find(second);
+    if (a != b) 
+    {
+        if (m_size[a] < m_size[b]) 
+        {
+            std::swap(a, b);
+        }
+        m_parent[b] = a;
+        m_size[a] += m_size[b];
+    }
+}
+
+void OverlapComponents::finish() 
+{
+    const size_t count = m_parent.size();
+    for (; m_nextFirst < count; ++m_nextFirst) 
+    {
+        m_pairBegin.push_back(m_pairs.size());
+    }
+
+    /* Number components by their lowest index; m_size is free to hold the numbers once the sets are final */
+    const size_t unnumbered = count;
+    m_size.assign(count, unnumbered);
+    m_componentOf.resize(count);
+    m_positionOf.resize(count);
+    m_componentBegin.assign(1, 0);
+
+    /* First count the members: entry c + 1 holds the size of component c until the prefix sum */
+    for (size_t i = 0; i < count; ++i) 
+    {
+        size_t root = find(i);
+        if (m_size[root] == unnumbered) 
+        {
+            m_size[root] = m_componentBegin.size() - 1;
+            m_componentBegin.push_back(0);
+        }
+        m_componentOf[i] = m_size[root];
+        m_positionOf[i] = m_componentBegin[m_size[root] + 1]++;
+    }
+
+    for (size_t c = 1; c < m_componentBegin.size(); ++c) 
+    {
+        m_componentBegin[c] += m_componentBegin[c - 1];
+    }
+
+    /* Members of a component appear by ascending index, at their counted positions */
+    m_members.resize(count);
+    for (size_t i = 0; i < count; ++i) 
+    {
+        m_members[m_componentBegin[m_componentOf[i]] + m_positionOf[i]] = i;
+    }
+}
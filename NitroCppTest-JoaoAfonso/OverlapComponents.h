@@ -0,0 +1,79 @@
+#ifndef OVERLAP_COMPONENTS_HPP
+#define OVERLAP_COMPONENTS_HPP
+
+#include <vector>
+#include <cstddef>
+#include "Rectangle.h"
+
+/**
+* @class OverlapComponents
+* @brief Connected components of the overlap graph, collected during a pairwise pass.
+*
+* Every overlapping pair is added as it is found; a union-find (union by size, path halving)
+* merges the components of its two rectangles, and the pair and its common region are kept
+* for the enumeration. finish() then lists the members of every component by ascending index.
+* Every intersecting group lies inside one component, since a rectangle overlapping a group's
+* common region overlaps each of its members, so components can be enumerated independently.
+*/
+class OverlapComponents 
+{
+public:
+    /**
+    * @struct Pair
+    * @brief An overlapping pair, stored under its first rectangle.
+    */
+    struct Pair 
+    {
+        size_t second;     /* Index of the second rectangle */
+        Rectangle region;  /* Common region of the two rectangles */
+    };
+
+private:
+    std::vector<size_t> m_parent;          /* Union-find parent of each rectangle */
+    std::vector<size_t> m_size;            /* Component size, valid at roots */
+    std::vector<Pair> m_pairs;             /* Pairs by first then second index */
+    std::vector<size_t> m_pairBegin;       /* First pair of each rectangle in m_pairs, plus an end entry */
+    size_t m_nextFirst = 0;                /* Rectangle whose pairs are being added */
+    std::vector<size_t> m_members;         /* Rectangle indices grouped by component, ascending in each */
+    std::vector<size_t> m_componentBegin;  /* Start of each component in m_members, plus an end entry */
+    std::vector<size_t> m_componentOf;     /* Component of each rectangle */
+    std::vector<size_t> m_positionOf;      /* Position of each rectangle among its component's members */
+
+    /**
+    * @brief Returns the root of a rectangle's set, halving the path on the way.
+    */
+    size_t find(size_t index);
+
+public:
+    /**
+    * @brief Starts a pass over 'count' rectangles, each in its own component. Keeps the capacity.
+    */
+    void reset(size_t count);
+
+    /**
+    * @brief Records an overlapping pair and merges the components of its rectangles.
+    *
+    * Pairs must be added by ascending first index, then ascending second index, as a
+    * pairwise pass produces them.
+    *
+    * @param first Index of the first rectangle.
+    * @param second Index of the second rectangle (greater than first).
+    * @param region Common region of the two rectangles.
+    */
+    void addPair(size_t first, size_t second, const Rectangle& region);
+
+    /**
+    * @brief Ends the pass: numbers the components by their lowest index and lists their members.
+    */
+    void finish();
+
+    inline size_t componentCount() const { return m_componentBegin.empty() ? 0 : m_componentBegin.size() - 1; }  /* Returns the number of components, singletons included. */
+    inline size_t componentOf(size_t index) const { return m_componentOf[index]; }  /* Returns the component of a rectangle. */
+    inline size_t positionOf(size_t index) const { return m_positionOf[index]; }    /* Returns the position of a rectangle among its component's members. */
+    inline size_t componentSize(size_t component) const { return m_componentBegin[component + 1] - m_componentBegin[component]; }  /* Returns the number of members. */
+    inline const size_t* members(size_t component) const { return m_members.data() + m_componentBegin[component]; }  /* Returns the members, by ascending index. */
+    inline const Pair* pairsBegin(size_t first) const { return m_pairs.data() + m_pairBegin[first]; }  /* Returns the first pair of a rectangle. */
+    inline const Pair* pairsEnd(size_t first) const { return m_pairs.data() + m_pairBegin[first + 1]; }  /* Returns the end of a rectangle's pairs. */
+};
+
+#endif // OVERLAP_COMPONENTS_HPP
@@ -0,0 +1,115 @@
+#include "OverlapCounter.h"
+#include "CoordinateCompression.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace 
+{
+    /* Binary indexed tree of counts over compressed coordinates */
+    class FenwickTree 
+    {
+    private:
+        std::vector<int64_t> m_tree;
+
+    public:
+        explicit FenwickTree(size_t size): m_tree(size + 1, 0) {}
+
+        /* Adds delta at a 0-based position */
+        void add(size_t position, int64_t delta) 
+        {
+            for (size_t i = position + 1; i < m_tree.size(); i += i & (~i + 1)) 
+            {
+                m_tree[i] += delta;
+            }
+        }
+
+        /* Sums the positions [0, end) */
+        int64_t prefix(size_t end) const 
+        {
+            int64_t sum = 0;
+            for (size_t i = end; i > 0; i -= i & (~i + 1)) 
+            {
+                sum += m_tree[i];
+            }
+            return sum;
+        }
+    };
+
+    /* An x edge; ends sort before starts at the same x so touching rectangles do not count */
+    struct Event 
+    {
+        int x;
+        bool is_start;
+        uint32_t index;
+
+        bool operator<(const Event& other) const 
+        {
+            if (x != other.x) 
+            {
+                return x < other.x;
+            }
+            return is_start < other.is_start;
+        }
+    };
+}
+
+uint64_t OverlapCounter::countOverlappingPairs(const std::vector<Rectangle>& rectangles) 
+{
+    std::vector<int> y_values;
+    std::vector<Event> events;
+    y_values.reserve(rectangles.size() * 2);
+    events.reserve(rectangles.size() * 2);
+
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        const auto& rect = rectangles[i];
+        y_values.push_back(rect.y());
+        y_values.push_back(rect.bottom());
+        events.push_back({rect.x(), true, static_cast<uint32_t>(i)});
+        events.push_back({rect.right(), false, static_cast<uint32_t>(i)});
+    }
+
+    const CoordinateCompression ys(std::move(y_values));
+    std::sort(events.begin(), events.end());
+
+    /* Compressed edges are looked up once per rectangle rather than once per event */
+    std::vector<uint32_t> top_index(rectangles.size());
+    std::vector<uint32_t> bottom_index(rectangles.size());
+    for (size_t i = 0; i < rectangles.size(); ++i) 
+    {
+        top_index[i] = static_cast<uint32_t>(ys.indexOf(rectangles[i].y()));
+        bottom_index[i] = static_cast<uint32_t>(ys.indexOf(rectangles[i].bottom()));
+    }
+
+    FenwickTree tops(ys.size());
+    FenwickTree bottoms(ys.size());
+    int64_t active = 0;
+    uint64_t pairs = 0;
+
+    for (const auto& event : events) 
+    {
+        const uint32_t top = top_index[event.index];
+        const uint32_t bottom = bottom_index[event.index];
+
+        if (event.is_start) 
+        {
+            /* Active rectangles entirely above (bottom <= top) or below (top >= bottom) */
+            int64_t above = bottoms.prefix(top + 1);
+            int64_t below = active - tops.prefix(bottom);
+            pairs += static_cast<uint64_t>(active - above - below);
+
+            tops.add(top, 1);
+            bottoms.add(bottom, 1);
+            ++active;
+        }
+        else 
+        {
+            tops.add(top, -1);
+            bottoms.add(bottom, -1);
+            --active;
+        }
+    }
+
+    return pairs;
+}
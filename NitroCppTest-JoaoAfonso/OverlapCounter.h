@@ -0,0 +1,32 @@
+#ifndef OVERLAP_COUNTER_HPP
+#define OVERLAP_COUNTER_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Rectangle.h"
+
+/**
+* @class OverlapCounter
+* @brief Counts overlapping rectangle pairs in O(n log n) without enumerating them.
+*
+* Sweeps the x edges in order. When a rectangle starts, the active rectangles whose
+* y interval misses it are exactly those ending above it or starting below it; two
+* Fenwick trees over compressed y (one keyed by top edge, one by bottom edge) count
+* both groups in O(log n).
+*/
+class OverlapCounter 
+{
+public:
+    /**
+    * @brief Counts the unordered pairs of rectangles that share a region of positive area.
+    *
+    * Rectangles that only touch along an edge or corner are not counted, matching
+    * Rectangle::calculate_intersection.
+    *
+    * @param rectangles Input rectangles (positive width and height).
+    * @return uint64_t Number of overlapping pairs.
+    */
+    static uint64_t countOverlappingPairs(const std::vector<Rectangle>& rectangles);
+};
+
+#endif // OVERLAP_COUNTER_HPP
@@ -0,0 +1,218 @@
+#include "PipelineRunner.h"
+#include "BoundedQueue.h"
+#include "TraceRecorder.h"
+
+#include <map>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace 
+{
+    /* Index marking the end of the stream in both queues */
+    const size_t kEndOfStream = static_cast<size_t>(-1);
+
+    /**
+    * @brief A scene travelling from the load stage to the compute stage.
+    */
+    struct ParsedScene 
+    {
+        size_t index = kEndOfStream;
+        std::vector<Rectangle> rectangles;
+        std::string text;    /* Header and loader messages, followed by the error if loading failed */
+        bool failed = false;
+    };
+
+    /**
+    * @brief A formatted output travelling from the compute stage to the writer.
+    */
+    struct SceneOutput 
+    {
+        size_t index = kEndOfStream;
+        std::string text;
+        bool failed = false;
+    };
+
+    ParsedScene parseScene(const BatchScene& scene, size_t index, size_t max_rectangles) 
+    {
+        ParsedScene parsed;
+        parsed.index = index;
+        std::ostringstream text;
+        text << "Scene " << scene.name << ":\n";
+
+        try 
+        {
+            if (scene.json.empty()) 
+            {
+                std::ifstream file(scene.name);
+                if (!file.is_open()) 
+                {
+                    throw std::runtime_error("Could not open file: " + scene.name);
+                }
+                parsed.rectangles = Rectangle::loadFromStream(file, max_rectangles, text);
+            }
+            else 
+            {
+                std::istringstream document(scene.json);
+                parsed.rectangles = Rectangle::loadFromStream(document, max_rectangles, text);
+            }
+        } 
+        catch (const std::exception& e) 
+        {
+            text << "Error: " << e.what() << "\n";
+            parsed.failed = true;
+        }
+
+        parsed.text = text.str();
+        return parsed;
+    }
+}
+
+size_t PipelineRunner::run(const std::vector<BatchScene>& scenes, const BatchOptions& options, size_t workers, std::ostream& out,
+                           size_t* peak_pending) 
+{
+    if (workers == 0) 
+    {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    MpmcQueue<ParsedScene> parsed_queue(PIPELINE_QUEUE_CAPACITY);
+    std::vector<std::unique_ptr<SpscQueue<SceneOutput>>> output_queues;
+    for (size_t i = 0; i < workers; ++i) 
+    {
+        output_queues.emplace_back(new SpscQueue<SceneOutput>(PIPELINE_QUEUE_CAPACITY));
+    }
+
+    /* Next scene to write, published by the writer so the loader can stay within the window */
+    const size_t window = PIPELINE_WINDOW_PER_WORKER * workers;
+    std::atomic<size_t> next_output{0};
+
+    /* Load stage: parse in input order, then tell every worker to stop */
+    std::thread loader([&]() {
+        TRACE_THREAD_NAME("loader");
+        const size_t max_rectangles = BatchRunner::inputLimit(options);
+        for (size_t i = 0; i < scenes.size(); ++i) 
+        {
+            unsigned attempts = 0;
+            while (i >= next_output.load(std::memory_order_acquire) + window) 
+            {
+                queue_detail::backoff(attempts);
+            }
+            parsed_queue.push(parseScene(scenes[i], i, max_rectangles));
+        }
+        for (size_t i = 0; i < workers; ++i) 
+        {
+            parsed_queue.push(ParsedScene());
+        }
+    });
+
+    /* Compute stage: each worker reuses one finder for every scene it takes */
+    std::vector<std::thread> computers;
+    for (size_t worker = 0; worker < workers; ++worker) 
+    {
+        computers.emplace_back([&, worker]() {
+            TRACE_THREAD_NAME("compute " + std::to_string(worker));
+            SceneWorker current;
+            SpscQueue<SceneOutput>& outputs = *output_queues[worker];
+            ParsedScene scene;
+
+            for (parsed_queue.pop(scene); scene.index != kEndOfStream; parsed_queue.pop(scene)) 
+            {
+                TRACE_SCOPE("scene");
+                SceneOutput output;
+                output.index = scene.index;
+                output.failed = scene.failed;
+
+                std::ostringstream text;
+                text << scene.text;
+                if (!scene.failed) 
+                {
+                    try 
+                    {
+                        current.beginScene();
+                        current.finder.loadRectangles(std::move(scene.rectangles));
+                        BatchRunner::processScene(current.finder, options, text);
+                    } 
+                    catch (const std::exception& e) 
+                    {
+                        text << "Error: " << e.what() << "\n";
+                        output.failed = true;
+                    }
+                }
+
+                output.text = text.str();
+                outputs.push(std::move(output));
+            }
+            outputs.push(SceneOutput());
+        });
+    }
+
+    /* Output stage: drain the workers round robin and write in input order */
+    std::map<size_t, std::string> pending;
+    size_t written = 0;
+    size_t peak = 0;
+    size_t failed = 0;
+    size_t running = workers;
+    std::vector<char> finished(workers, 0);
+    unsigned attempts = 0;
+
+    while (running > 0) 
+    {
+        bool progressed = false;
+        for (size_t worker = 0; worker < workers; ++worker) 
+        {
+            SceneOutput output;
+            while (!finished[worker] && output_queues[worker]->tryPop(output)) 
+            {
+                progressed = true;
+                if (output.index == kEndOfStream) 
+                {
+                    finished[worker] = 1;
+                    --running;
+                    break;
+                }
+
+                failed += output.failed;
+                pending.emplace(output.index, std::move(output.text));
+                peak = std::max(peak, pending.size());
+            }
+        }
+
+        if (!pending.empty() && pending.begin()->first == written) 
+        {
+            TRACE_SCOPE("merge");
+            for (auto it = pending.begin(); it != pending.end() && it->first == written; it = pending.erase(it)) 
+            {
+                out << it->second;
+                ++written;
+            }
+            next_output.store(written, std::memory_order_release);
+        }
+
+        if (progressed) 
+        {
+            attempts = 0;
+        }
+        else 
+        {
+            queue_detail::backoff(attempts);
+        }
+    }
+
+    loader.join();
+    for (auto& computer : computers) 
+    {
+        computer.join();
+    }
+
+    out.flush();
+    if (peak_pending) 
+    {
+        *peak_pending = peak;
+    }
+    return failed;
+}
@@ -0,0 +1,47 @@
+#ifndef PIPELINE_RUNNER_HPP
+#define PIPELINE_RUNNER_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include "BatchRunner.h"
+
+/* Scenes that may wait between two pipeline stages before the upstream stage blocks */
+#define PIPELINE_QUEUE_CAPACITY 64
+
+/* Scenes per worker the loader may run ahead of the writer; bounds the reorder buffer */
+#define PIPELINE_WINDOW_PER_WORKER 16u
+
+/**
+* @class PipelineRunner
+* @brief Processes a batch as three overlapping stages connected by bounded queues.
+*
+* - Load: one thread reads and parses the scenes in input order.
+* - Compute: workers take parsed scenes from a shared MPMC queue, run the selected mode and
+*   format the output; each worker hands its outputs to the writer through its own SPSC queue.
+* - Output: the calling thread collects outputs, restores input order in a reorder buffer and
+*   writes them.
+*
+* While one scene is being parsed, earlier ones are computed and written, so disk, CPU and
+* output overlap. Full queues block their producer, and the loader waits while it is
+* PIPELINE_WINDOW_PER_WORKER scenes per worker ahead of the writer, so a slow scene holds back
+* at most that many outputs in the reorder buffer. The output is identical to
+* BatchRunner::run() for the same scenes.
+*/
+class PipelineRunner 
+{
+public:
+    /**
+    * @brief Runs the pipeline over a batch.
+    * @param scenes Scenes to process.
+    * @param options Mode and result limit.
+    * @param workers Compute workers; 0 uses the hardware concurrency.
+    * @param out Destination of the outputs, each preceded by a "Scene <name>:" header.
+    * @param peak_pending If not null, receives the largest number of outputs held in the reorder buffer.
+    * @return Number of scenes that failed.
+    */
+    static size_t run(const std::vector<BatchScene>& scenes, const BatchOptions& options, size_t workers, std::ostream& out,
+                      size_t* peak_pending = nullptr);
+};
+
+#endif // PIPELINE_RUNNER_HPP
@@ -0,0 +1,190 @@
+#include "RasterCoverage.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+namespace 
+{
+    /* Bounding box as 64-bit extents so that far-apart rectangles cannot overflow */
+    bool boundingBox(const std::vector<Rectangle>& rectangles, int& x, int& y, int64_t& width, int64_t& height) 
+    {
+        bool boReturn = false;
+
+        if (!rectangles.empty()) 
+        {
+            int left = INT_MAX, top = INT_MAX;
+            int64_t right = INT64_MIN, bottom = INT64_MIN;
+
+            for (const auto& rect : rectangles) 
+            {
+                left = std::min(left, rect.x());
+                top = std::min(top, rect.y());
+                right = std::max(right, static_cast<int64_t>(rect.x()) + rect.w());
+                bottom = std::max(bottom, static_cast<int64_t>(rect.y()) + rect.h());
+            }
+
+            x = left;
+            y = top;
+            width = right - left;
+            height = bottom - top;
+            boReturn = true;
+        }
+
+        return boReturn;
+    }
+}
+
+RasterCoverage::RasterCoverage(const std::vector<Rectangle>& rectangles): m_originX(0), 
+                                                                          m_originY(0), 
+                                                                          m_width(0), 
+                                                                          m_height(0) 
+{
+    int64_t width = 0;
+    int64_t height = 0;
+
+    if (!boundingBox(rectangles, m_originX, m_originY, width, height)) 
+    {
+        return;
+    }
+
+    if (width * height > static_cast<int64_t>(RASTER_MAX_CELLS)) 
+    {
+        throw std::runtime_error("Bounding box too large to rasterize: " + std::to_string(width) + "x" + std::to_string(height));
+    }
+
+    m_width = static_cast<size_t>(width);
+    m_height = static_cast<size_t>(height);
+
+    /* Difference array with one spare row and column for the far corners */
+    const size_t stride = m_width + 1;
+    std::vector<int32_t> diff(stride * (m_height + 1), 0);
+
+    for (const auto& rect : rectangles) 
+    {
+        size_t x0 = static_cast<size_t>(rect.x() - m_originX);
+        size_t y0 = static_cast<size_t>(rect.y() - m_originY);
+        size_t x1 = x0 + static_cast<size_t>(rect.w());
+        size_t y1 = y0 + static_cast<size_t>(rect.h());
+
+        diff[y0 * stride + x0] += 1;
+        diff[y0 * stride + x1] -= 1;
+        diff[y1 * stride + x0] -= 1;
+        diff[y1 * stride + x1] += 1;
+    }
+
+    /* Column pass: each row accumulates the previous one (contiguous, vectorizable) */
+    for (size_t row = 1; row < m_height; ++row) 
+    {
+        int32_t* current = diff.data() + row * stride;
+        const int32_t* previous = current - stride;
+        for (size_t col = 0; col < stride; ++col) 
+        {
+            current[col] += previous[col];
+        }
+    }
+
+    /* Row pass: running sum along x, dropping the spare column */
+    m_depth.resize(m_width * m_height);
+    for (size_t row = 0; row < m_height; ++row) 
+    {
+        const int32_t* source = diff.data() + row * stride;
+        int32_t* target = m_depth.data() + row * m_width;
+        int32_t running = 0;
+        for (size_t col = 0; col < m_width; ++col) 
+        {
+            running += source[col];
+            target[col] = running;
+        }
+    }
+}
+
+bool RasterCoverage::isSuitable(const std::vector<Rectangle>& rectangles) 
+{
+    int x = 0;
+    int y = 0;
+    int64_t width = 0;
+    int64_t height = 0;
+
+    if (!boundingBox(rectangles, x, y, width, height)) 
+    {
+        return false;
+    }
+
+    /* Compare in floating point: the product of two far-apart extents can overflow */
+    const double cells = static_cast<double>(width) * static_cast<double>(height);
+    return cells <= RASTER_MAX_CELLS && cells <= static_cast<double>(RASTER_MAX_CELLS_PER_RECTANGLE) * rectangles.size();
+}
+
+int RasterCoverage::depthAt(int x, int y) const 
+{
+    const int64_t col = static_cast<int64_t>(x) - m_originX;
+    const int64_t row = static_cast<int64_t>(y) - m_originY;
+
+    if (col < 0 || row < 0 || col >= static_cast<int64_t>(m_width) || row >= static_cast<int64_t>(m_height)) 
+    {
+        return 0;
+    }
+
+    return m_depth[static_cast<size_t>(row) * m_width + static_cast<size_t>(col)];
+}
+
+IntersectionResult RasterCoverage::findMaxDepth(const std::vector<Rectangle>& rectangles) const 
+{
+    IntersectionResult result{Rectangle(-1, 0, 0, 0, 0), {}};
+
+    if (m_depth.empty()) 
+    {
+        return result;
+    }
+
+    /* Max reduction first (vectorizable), then locate the first cell reaching it */
+    int32_t best = 0;
+    for (int32_t depth : m_depth) 
+    {
+        best = std::max(best, depth);
+    }
+    const size_t cell = static_cast<size_t>(std::find(m_depth.begin(), m_depth.end(), best) - m_depth.begin());
+
+    const int x = m_originX + static_cast<int>(cell % m_width);
+    const int y = m_originY + static_cast<int>(cell / m_width);
+    result.rect = Rectangle(-1, x, y, 1, 1);
+
+    for (const auto& rect : rectangles) 
+    {
+        if (rect.x() <= x && x < rect.right() && rect.y() <= y && y < rect.bottom()) 
+        {
+            result.parent_ids.push_back(rect.id());
+        }
+    }
+    std::sort(result.parent_ids.begin(), result.parent_ids.end());
+
+    return result;
+}
+
+AreaStats RasterCoverage::computeAreaStats() const 
+{
+    AreaStats stats;
+
+    for (int32_t depth : m_depth) 
+    {
+        if (static_cast<size_t>(depth) >= stats.area_by_depth.size()) 
+        {
+            stats.area_by_depth.resize(static_cast<size_t>(depth) + 1, 0);
+        }
+        ++stats.area_by_depth[static_cast<size_t>(depth)];
+    }
+
+    if (!stats.area_by_depth.empty()) 
+    {
+        stats.union_area = static_cast<int64_t>(m_depth.size()) - stats.area_by_depth[0];
+        stats.area_by_depth[0] = 0;
+    }
+
+    while (!stats.area_by_depth.empty() && stats.area_by_depth.back() == 0) 
+    {
+        stats.area_by_depth.pop_back();
+    }
+
+    return stats;
+}
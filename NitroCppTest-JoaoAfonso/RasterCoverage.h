@@ -0,0 +1,76 @@
+#ifndef RASTER_COVERAGE_HPP
+#define RASTER_COVERAGE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Rectangle.h"
+#include "IntersectionFinder.h"
+
+/* Largest raster (in cells) that is built automatically: a 4096x4096 canvas, 64 MiB of counts */
+#define RASTER_MAX_CELLS (4096u * 4096u)
+
+/* The raster is only worth building when it is not much larger than the input itself */
+#define RASTER_MAX_CELLS_PER_RECTANGLE 64u
+
+/**
+* @class RasterCoverage
+* @brief Dense per-cell coverage counts over the bounding box of a rectangle set.
+*
+* Intended for scenes living on a small integer canvas (e.g. screen space). Each rectangle
+* adds four corners to a 2D difference array; two prefix-sum passes then turn it into the
+* number of rectangles covering every unit cell. The column pass adds whole rows at a time,
+* which compilers vectorize. Afterwards a stabbing query is a single load, and depth or area
+* queries are linear scans over contiguous memory.
+*/
+class RasterCoverage 
+{
+private:
+    int m_originX;                /* X-coordinate of the first column. */
+    int m_originY;                /* Y-coordinate of the first row. */
+    size_t m_width;               /* Number of columns. */
+    size_t m_height;              /* Number of rows. */
+    std::vector<int32_t> m_depth; /* Row-major coverage counts, m_width * m_height cells. */
+
+public:
+    /**
+    * @brief Rasterizes the rectangles over their bounding box.
+    * @param rectangles Input rectangles (positive width and height).
+    * @throws std::runtime_error if the bounding box exceeds RASTER_MAX_CELLS.
+    */
+    explicit RasterCoverage(const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Decides whether a rectangle set should be handled by the raster engine.
+    *
+    * True when the bounding box has at most RASTER_MAX_CELLS cells and no more than
+    * RASTER_MAX_CELLS_PER_RECTANGLE cells per rectangle.
+    *
+    * @param rectangles Input rectangles.
+    * @return true if rasterizing is cheaper than sweeping.
+    */
+    static bool isSuitable(const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Stabbing query: number of rectangles covering the unit cell at (x, y).
+    * @param x X-coordinate of the cell.
+    * @param y Y-coordinate of the cell.
+    * @return int The coverage count, 0 outside the bounding box.
+    */
+    int depthAt(int x, int y) const;
+
+    /**
+    * @brief Finds the deepest cell, with the same contract as DepthQuery::findMaxDepth.
+    * @param rectangles The rectangles the raster was built from, used to report the IDs.
+    * @return IntersectionResult A 1x1 witness cell and the IDs covering it (ascending).
+    */
+    IntersectionResult findMaxDepth(const std::vector<Rectangle>& rectangles) const;
+
+    /**
+    * @brief Computes union and per-depth areas, with the same contract as AreaCalculator.
+    * @return AreaStats The union area and the per-depth areas.
+    */
+    AreaStats computeAreaStats() const;
+};
+
+#endif // RASTER_COVERAGE_HPP
@@ -0,0 +1,324 @@
+#include "ResultCache.h"
+
+#include <cstdio>
+#include <tuple>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <unistd.h>
+
+namespace 
+{
+    /* Identifies cache files and their layout version */
+    const char kMagic[8] = {'N', 'R', 'C', 'A', 'C', 'H', 'E', '1'};
+
+    std::vector<int32_t> canonicalCoordinates(const std::vector<Rectangle>& rectangles, const std::vector<size_t>& order) 
+    {
+        std::vector<int32_t> coordinates;
+        coordinates.reserve(order.size() * 4);
+        for (size_t position : order) 
+        {
+            const Rectangle& rect = rectangles[position];
+            coordinates.insert(coordinates.end(), {rect.x(), rect.y(), rect.w(), rect.h()});
+        }
+        return coordinates;
+    }
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size) 
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) 
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashCoordinates(const std::string& mode, const std::vector<int32_t>& coordinates) 
+    {
+        uint64_t hash = 14695981039346656037ull;
+        uint32_t length = static_cast<uint32_t>(mode.size());
+        hash = fnv1a(hash, &length, sizeof(length));
+        hash = fnv1a(hash, mode.data(), mode.size());
+        return fnv1a(hash, coordinates.data(), coordinates.size() * sizeof(int32_t));
+    }
+
+    template <typename T>
+    void writeValue(std::ostream& out, const T& value) 
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool readValue(std::istream& in, T& value) 
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+ResultCache::ResultCache(const std::string& directory, size_t memory_entries)
+    : m_directory(directory), 
+      m_capacity(std::max<size_t>(1, memory_entries)) 
+{
+    if (!m_directory.empty()) 
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (!std::filesystem::is_directory(m_directory, error)) 
+        {
+            throw std::runtime_error("Could not create cache directory: " + m_directory);
+        }
+    }
+}
+
+std::vector<size_t> ResultCache::canonicalOrder(const std::vector<Rectangle>& rectangles) 
+{
+    std::vector<size_t> order(rectangles.size());
+    for (size_t i = 0; i < order.size(); ++i) 
+    {
+        order[i] = i;
+    }
+
+    /* Equal rectangles are interchangeable, so their relative order does not affect the results */
+    std::sort(order.begin(), order.end(), [&rectangles](size_t a, size_t b) {
+        const Rectangle& ra = rectangles[a];
+        const Rectangle& rb = rectangles[b];
+        return std::make_tuple(ra.x(), ra.y(), ra.w(), ra.h()) < std::make_tuple(rb.x(), rb.y(), rb.w(), rb.h());
+    });
+    return order;
+}
+
+uint64_t ResultCache::hashScene(const std::string& mode, const std::vector<Rectangle>& rectangles) 
+{
+    return hashCoordinates(mode, canonicalCoordinates(rectangles, canonicalOrder(rectangles)));
+}
+
+std::string ResultCache::entryPath(uint64_t hash) const 
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hash << ".nrc";
+    return (std::filesystem::path(m_directory) / name.str()).string();
+}
+
+void ResultCache::remember(Entry&& entry) 
+{
+    auto existing = m_byHash.find(entry.hash);
+    if (existing != m_byHash.end()) 
+    {
+        m_entries.erase(existing->second);
+        m_byHash.erase(existing);
+    }
+
+    m_entries.push_front(std::move(entry));
+    m_byHash[m_entries.front().hash] = m_entries.begin();
+
+    if (m_entries.size() > m_capacity) 
+    {
+        m_byHash.erase(m_entries.back().hash);
+        m_entries.pop_back();
+    }
+}
+
+bool ResultCache::readEntry(uint64_t hash, Entry& entry) const 
+{
+    std::ifstream in(entryPath(hash), std::ios::binary);
+    char magic[sizeof(kMagic)];
+    uint32_t length = 0;
+    uint32_t count = 0;
+
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kMagic) || !readValue(in, length)) 
+    {
+        return false;
+    }
+
+    /* Sizes are checked against the file length before anything is allocated */
+    std::error_code error;
+    const uint64_t file_size = std::filesystem::file_size(entryPath(hash), error);
+    if (error || length > file_size) 
+    {
+        return false;
+    }
+    entry.mode.resize(length);
+    if (!in.read(&entry.mode[0], length) || !readValue(in, count) || uint64_t(count) * 16 > file_size) 
+    {
+        return false;
+    }
+
+    entry.hash = hash;
+    entry.coordinates.resize(size_t(count) * 4);
+    if (!in.read(reinterpret_cast<char*>(entry.coordinates.data()), entry.coordinates.size() * sizeof(int32_t)) ||
+        !readValue(in, count) || uint64_t(count) * 20 > file_size) 
+    {
+        return false;
+    }
+
+    entry.results.clear();
+    entry.results.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) 
+    {
+        int32_t x = 0, y = 0, w = 0, h = 0;
+        uint32_t size = 0;
+        if (!readValue(in, x) || !readValue(in, y) || !readValue(in, w) || !readValue(in, h) || !readValue(in, size) ||
+            size > entry.coordinates.size() / 4) 
+        {
+            return false;
+        }
+
+        IntersectionResult result{Rectangle(-1, x, y, w, h), std::pmr::vector<int>(size)};
+        if (size != 0 && !in.read(reinterpret_cast<char*>(result.parent_ids.data()), size * sizeof(int32_t))) 
+        {
+            return false;
+        }
+        entry.results.push_back(std::move(result));
+    }
+    return true;
+}
+
+void ResultCache::writeEntry(const Entry& entry) const 
+{
+    const std::string path = entryPath(entry.hash);
+    std::ostringstream suffix;
+    /* Unique per process and thread, since several processes may share the directory */
+    suffix << ".tmp" << getpid() << "." << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temporary = path + suffix.str();
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(kMagic, sizeof(kMagic));
+        writeValue(out, static_cast<uint32_t>(entry.mode.size()));
+        out.write(entry.mode.data(), entry.mode.size());
+        writeValue(out, static_cast<uint32_t>(entry.coordinates.size() / 4));
+        out.write(reinterpret_cast<const char*>(entry.coordinates.data()), entry.coordinates.size() * sizeof(int32_t));
+        writeValue(out, static_cast<uint32_t>(entry.results.size()));
+
+        for (const auto& result : entry.results) 
+        {
+            writeValue(out, static_cast<int32_t>(result.rect.x()));
+            writeValue(out, static_cast<int32_t>(result.rect.y()));
+            writeValue(out, static_cast<int32_t>(result.rect.w()));
+            writeValue(out, static_cast<int32_t>(result.rect.h()));
+            writeValue(out, static_cast<uint32_t>(result.parent_ids.size()));
+            out.write(reinterpret_cast<const char*>(result.parent_ids.data()), result.parent_ids.size() * sizeof(int32_t));
+        }
+
+        if (!out) 
+        {
+            /* A cache that cannot be written only costs speed; the results are still correct */
+            out.close();
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) 
+    {
+        std::remove(temporary.c_str());
+    }
+}
+
+bool ResultCache::lookup(const std::string& mode, const std::vector<Rectangle>& rectangles, std::vector<IntersectionResult>& results) 
+{
+    const std::vector<size_t> order = canonicalOrder(rectangles);
+    const std::vector<int32_t> coordinates = canonicalCoordinates(rectangles, order);
+    const uint64_t hash = hashCoordinates(mode, coordinates);
+    std::vector<IntersectionResult> canonical;
+    bool boReturn = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_byHash.find(hash);
+        if (found != m_byHash.end() && found->second->mode == mode && found->second->coordinates == coordinates) 
+        {
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            canonical = found->second->results;
+            boReturn = true;
+        }
+    }
+
+    Entry entry;
+    if (!boReturn && !m_directory.empty() && readEntry(hash, entry) && entry.mode == mode && entry.coordinates == coordinates) 
+    {
+        canonical = entry.results;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        remember(std::move(entry));
+        boReturn = true;
+    }
+
+    /* Canonical ID k is the k-th rectangle in canonical order; an entry naming any other ID is a miss */
+    for (auto result = canonical.begin(); boReturn && result != canonical.end(); ++result) 
+    {
+        for (int& id : result->parent_ids) 
+        {
+            if (id < 1 || static_cast<size_t>(id) > order.size()) 
+            {
+                boReturn = false;
+                break;
+            }
+            id = rectangles[order[id - 1]].id();
+        }
+        std::sort(result->parent_ids.begin(), result->parent_ids.end());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++(boReturn ? m_hits : m_misses);
+    }
+
+    if (boReturn) 
+    {
+        results = std::move(canonical);
+    }
+
+    return boReturn;
+}
+
+void ResultCache::store(const std::string& mode, const std::vector<Rectangle>& rectangles, const std::vector<IntersectionResult>& results) 
+{
+    Entry entry;
+    const std::vector<size_t> order = canonicalOrder(rectangles);
+    entry.coordinates = canonicalCoordinates(rectangles, order);
+    entry.hash = hashCoordinates(mode, entry.coordinates);
+    entry.mode = mode;
+
+    std::unordered_map<int, int> canonical_ids;
+    for (size_t k = 0; k < order.size(); ++k) 
+    {
+        canonical_ids[rectangles[order[k]].id()] = static_cast<int>(k + 1);
+    }
+
+    entry.results = results;
+    for (auto& result : entry.results) 
+    {
+        for (int& id : result.parent_ids) 
+        {
+            id = canonical_ids.at(id);
+        }
+    }
+
+    if (!m_directory.empty()) 
+    {
+        writeEntry(entry);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    remember(std::move(entry));
+}
+
+uint64_t ResultCache::hits() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+uint64_t ResultCache::misses() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
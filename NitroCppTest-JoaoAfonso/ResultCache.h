@@ -0,0 +1,114 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "Rectangle.h"
+#include "IntersectionFinder.h"
+
+/* Number of scenes kept in the in-memory front of the cache */
+#define RESULT_CACHE_MEMORY_ENTRIES 1024
+
+/**
+* @class ResultCache
+* @brief Stores enumeration results keyed by the content of a scene.
+*
+* The key is a hash of the rectangle multiset: rectangles are sorted by (x, y, w, h) and
+* renumbered 1..n in that order, so scenes listing the same rectangles in another order or
+* with other IDs share one entry. Results are stored over these canonical IDs and mapped
+* back to the caller's IDs on a hit. Entries keep their canonical rectangles, so a hash
+* collision is detected and treated as a miss.
+*
+* Entries live in a small LRU list in memory and, when a directory is given, in one file
+* per scene on disk, which survives restarts and is shared between processes. All methods
+* are thread safe.
+*/
+class ResultCache 
+{
+private:
+    /**
+    * @struct Entry
+    * @brief A cached scene in canonical form.
+    */
+    struct Entry 
+    {
+        uint64_t hash = 0;
+        std::string mode;
+        std::vector<int32_t> coordinates;          /* x, y, w, h of every canonical rectangle */
+        std::vector<IntersectionResult> results;   /* Results over canonical IDs */
+    };
+
+    std::string m_directory;                       /* On-disk store; empty keeps the cache in memory only */
+    size_t m_capacity;                             /* Maximum entries held in memory */
+    std::list<Entry> m_entries;                    /* Most recently used first */
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_byHash;
+    mutable std::mutex m_mutex;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+
+    std::string entryPath(uint64_t hash) const;
+
+    /**
+    * @brief Moves an entry to the front of the LRU list, evicting the oldest entry when full.
+    */
+    void remember(Entry&& entry);
+
+    /**
+    * @brief Reads an entry from disk.
+    * @return false if there is no readable entry for the hash.
+    */
+    bool readEntry(uint64_t hash, Entry& entry) const;
+
+    /**
+    * @brief Writes an entry to disk through a temporary file and a rename, so readers never see partial files.
+    */
+    void writeEntry(const Entry& entry) const;
+
+public:
+    /**
+    * @brief Opens a cache.
+    * @param directory Directory of the on-disk store, created if missing; empty for memory only.
+    * @param memory_entries Capacity of the in-memory LRU front.
+    * @throws std::runtime_error if the directory cannot be created.
+    */
+    explicit ResultCache(const std::string& directory, size_t memory_entries = RESULT_CACHE_MEMORY_ENTRIES);
+
+    /**
+    * @brief Returns the canonical order of a scene: positions into rectangles, sorted by (x, y, w, h).
+    */
+    static std::vector<size_t> canonicalOrder(const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Hashes a scene independently of rectangle order and IDs.
+    * @param mode Mode the results were computed with.
+    * @param rectangles The scene.
+    * @return 64-bit FNV-1a hash of the mode and the canonical rectangles.
+    */
+    static uint64_t hashScene(const std::string& mode, const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Looks up the results of a scene.
+    * @param mode Mode the results are wanted for.
+    * @param rectangles The scene.
+    * @param results Receives the results over the scene's own IDs on a hit.
+    * @return true on a hit.
+    */
+    bool lookup(const std::string& mode, const std::vector<Rectangle>& rectangles, std::vector<IntersectionResult>& results);
+
+    /**
+    * @brief Stores the results of a scene.
+    * @param mode Mode the results were computed with.
+    * @param rectangles The scene.
+    * @param results Results over the scene's own IDs.
+    */
+    void store(const std::string& mode, const std::vector<Rectangle>& rectangles, const std::vector<IntersectionResult>& results);
+
+    uint64_t hits() const;    /* Returns the number of successful lookups. */
+    uint64_t misses() const;  /* Returns the number of failed lookups. */
+};
+
+#endif // RESULT_CACHE_HPP
@@ -0,0 +1,306 @@
+#include "RunStats.h"
+#include "json.hpp"
+
+#include <new>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+std::atomic<bool> RunStats::s_enabled{false};
+
+namespace 
+{
+    const char* const kPhaseNames[] = {"parse", "load", "pairwise", "recursion", "maximal", "cells", "counting",
+                                       "sort", "print"};
+
+    uint64_t nowNanoseconds() 
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /* Statistics of one thread. Only the owning thread writes them, so updates are a relaxed load and store
+       instead of a contended read-modify-write; the atomics only make concurrent reports well defined */
+    struct StatsBlock 
+    {
+        std::atomic<uint64_t> counters[RunStats::kCounters] {};
+        std::atomic<uint64_t> phase_ns[RunStats::kPhases] {};
+        std::atomic<uint64_t> depths[RUN_STATS_MAX_DEPTH + 1] {};
+
+        void clear() 
+        {
+            for (auto& value : counters) 
+            {
+                value.store(0, std::memory_order_relaxed);
+            }
+            for (auto& value : phase_ns) 
+            {
+                value.store(0, std::memory_order_relaxed);
+            }
+            for (auto& value : depths) 
+            {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void addTo(StatsBlock& sum) const;
+    };
+
+    inline void bump(std::atomic<uint64_t>& value, uint64_t amount) 
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void StatsBlock::addTo(StatsBlock& sum) const 
+    {
+        for (size_t i = 0; i < RunStats::kCounters; ++i) 
+        {
+            bump(sum.counters[i], counters[i].load(std::memory_order_relaxed));
+        }
+        for (size_t i = 0; i < RunStats::kPhases; ++i) 
+        {
+            bump(sum.phase_ns[i], phase_ns[i].load(std::memory_order_relaxed));
+        }
+        for (size_t i = 0; i <= RUN_STATS_MAX_DEPTH; ++i) 
+        {
+            bump(sum.depths[i], depths[i].load(std::memory_order_relaxed));
+        }
+    }
+
+    struct ThreadStats;
+
+    /* Live thread blocks, plus the totals of threads that already exited */
+    struct Registry 
+    {
+        std::mutex mutex;
+        ThreadStats* head = nullptr;
+        StatsBlock retired;
+        std::atomic<uint64_t> start_ns{0};
+    };
+
+    Registry& registry() 
+    {
+        /* Function-local and never allocating: operator new may reach it before main */
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadStats : StatsBlock 
+    {
+        int phase = -1;          /* Phase being timed, or -1 */
+        uint64_t since = 0;      /* When the current phase was last charged */
+        ThreadStats* next = nullptr;
+
+        ThreadStats() 
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            next = shared.head;
+            shared.head = this;
+        }
+
+        ~ThreadStats() 
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            addTo(shared.retired);
+
+            ThreadStats** link = &shared.head;
+            while (*link != this) 
+            {
+                link = &(*link)->next;
+            }
+            *link = next;
+        }
+    };
+
+    ThreadStats& local() 
+    {
+        thread_local ThreadStats stats;
+        return stats;
+    }
+
+    /* Stops operator new from recursing when the hook itself allocates while registering the calling thread */
+    thread_local bool t_inAllocationHook = false;
+
+    /* Allocations of the calling thread, counted even while collection is off (see threadAllocations) */
+    thread_local uint64_t t_allocations = 0;
+
+    template <typename Read>
+    uint64_t sumAll(Read read) 
+    {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        uint64_t sum = read(shared.retired);
+        for (ThreadStats* stats = shared.head; stats != nullptr; stats = stats->next) 
+        {
+            sum += read(*stats);
+        }
+        return sum;
+    }
+}
+
+void RunStats::enable(bool on) 
+{
+    if (on) 
+    {
+        registry().start_ns.store(nowNanoseconds(), std::memory_order_relaxed);
+    }
+    s_enabled.store(on, std::memory_order_relaxed);
+}
+
+void RunStats::reset() 
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.retired.clear();
+    for (ThreadStats* stats = shared.head; stats != nullptr; stats = stats->next) 
+    {
+        stats->clear();
+    }
+    shared.start_ns.store(nowNanoseconds(), std::memory_order_relaxed);
+}
+
+void RunStats::add(StatsCounter counter, uint64_t amount) 
+{
+    bump(local().counters[static_cast<size_t>(counter)], amount);
+}
+
+void RunStats::addDepth(size_t depth) 
+{
+    bump(local().depths[std::min<size_t>(depth, RUN_STATS_MAX_DEPTH)], 1);
+}
+
+void RunStats::countAllocation(size_t bytes) 
+{
+    if (!t_inAllocationHook) 
+    {
+        t_inAllocationHook = true;
+        ThreadStats& stats = local();
+        bump(stats.counters[static_cast<size_t>(StatsCounter::Allocations)], 1);
+        bump(stats.counters[static_cast<size_t>(StatsCounter::AllocatedBytes)], bytes);
+        t_inAllocationHook = false;
+    }
+}
+
+uint64_t RunStats::threadAllocations() 
+{
+    return t_allocations;
+}
+
+int RunStats::enter(StatsPhase phase) 
+{
+    ThreadStats& stats = local();
+    uint64_t now = nowNanoseconds();
+    if (stats.phase >= 0) 
+    {
+        bump(stats.phase_ns[stats.phase], now - stats.since);
+    }
+
+    int parent = stats.phase;
+    stats.phase = static_cast<int>(phase);
+    stats.since = now;
+    return parent;
+}
+
+void RunStats::leave(int parent) 
+{
+    ThreadStats& stats = local();
+    uint64_t now = nowNanoseconds();
+    if (stats.phase >= 0) 
+    {
+        bump(stats.phase_ns[stats.phase], now - stats.since);
+    }
+
+    stats.phase = parent;
+    stats.since = now;
+}
+
+uint64_t RunStats::total(StatsCounter counter) 
+{
+    size_t index = static_cast<size_t>(counter);
+    return sumAll([index](const StatsBlock& block) { return block.counters[index].load(std::memory_order_relaxed); });
+}
+
+double RunStats::seconds(StatsPhase phase) 
+{
+    size_t index = static_cast<size_t>(phase);
+    return sumAll([index](const StatsBlock& block) { return block.phase_ns[index].load(std::memory_order_relaxed); }) / 1e9;
+}
+
+uint64_t RunStats::depthCount(size_t depth) 
+{
+    size_t index = std::min<size_t>(depth, RUN_STATS_MAX_DEPTH);
+    return sumAll([index](const StatsBlock& block) { return block.depths[index].load(std::memory_order_relaxed); });
+}
+
+const char* RunStats::name(StatsPhase phase) 
+{
+    return kPhaseNames[static_cast<size_t>(phase)];
+}
+
+void RunStats::writeJson(std::ostream& out) 
+{
+    nlohmann::ordered_json report;
+    report["wall_seconds"] = (nowNanoseconds() - registry().start_ns.load(std::memory_order_relaxed)) / 1e9;
+
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (size_t i = 0; i < kPhases; ++i) 
+    {
+        phases[name(static_cast<StatsPhase>(i))] = seconds(static_cast<StatsPhase>(i));
+    }
+    report["phase_seconds"] = phases;
+
+    uint64_t tests = total(StatsCounter::IntersectionTests);
+    uint64_t hits = total(StatsCounter::IntersectionHits);
+    report["calculate_intersection"] = {{"calls", tests}, {"hits", hits}, {"misses", tests - hits}};
+
+    /* Only the depths reached, keyed by group size; the last bucket collects everything deeper */
+    nlohmann::ordered_json depths = nlohmann::ordered_json::object();
+    for (size_t depth = 0; depth <= RUN_STATS_MAX_DEPTH; ++depth) 
+    {
+        uint64_t steps = depthCount(depth);
+        if (steps != 0) 
+        {
+            depths[std::to_string(depth) + (depth == RUN_STATS_MAX_DEPTH ? "+" : "")] = steps;
+        }
+    }
+    report["recursion_depth"] = depths;
+
+    report["allocations"] = {{"count", total(StatsCounter::Allocations)}, {"bytes", total(StatsCounter::AllocatedBytes)}};
+
+    out << report.dump(2) << "\n";
+}
+
+#ifdef INTERSECTION_STATS
+/* Replaces the global allocator to count allocations while collecting; array and nothrow forms forward here.
+   The sized delete is replaced too, since the compiler calls it directly when it knows the size; it is kept
+   out of line so GCC does not inline its free() into callers and report it as mismatched with operator new. */
+void* operator new(std::size_t size) 
+{
+    ++t_allocations;
+    if (RunStats::enabled()) 
+    {
+        RunStats::countAllocation(size);
+    }
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) 
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept 
+{
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept 
+{
+    std::free(memory);
+}
+#endif
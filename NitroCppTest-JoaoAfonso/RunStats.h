@@ -0,0 +1,195 @@
+#ifndef RUN_STATS_HPP
+#define RUN_STATS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+/* Group sizes from this value up share the last bucket of the recursion depth histogram */
+#define RUN_STATS_MAX_DEPTH 64
+
+/**
+* @brief Phases whose wall time is measured. Nested phases are charged exclusively: time spent
+* sorting is not also counted as printing.
+*/
+enum class StatsPhase 
+{
+    Parse,       /* json::parse of the input */
+    Load,        /* Validating the parsed rectangles */
+    Pairwise,    /* The pairwise pass of processIntersections */
+    Recursion,   /* Extending pairs into larger groups (IntersectionFinder::searchGroupsFrom) */
+    Maximal,     /* processMaximalIntersections */
+    Cells,       /* processArrangementCells */
+    Counting,    /* Count, depth and area engines */
+    Sort,        /* Sorting the results for output */
+    Print        /* Formatting the results */
+};
+
+/**
+* @brief Event counters.
+*/
+enum class StatsCounter 
+{
+    IntersectionTests,   /* Calls of Rectangle::calculate_intersection */
+    IntersectionHits,    /* Calls that found an overlap */
+    Allocations,         /* Calls of operator new */
+    AllocatedBytes       /* Bytes requested from operator new */
+};
+
+/**
+* @class RunStats
+* @brief Process-wide runtime statistics, reported as JSON at the end of a run (--stats).
+*
+* Collection is compiled in only when INTERSECTION_STATS is defined (the CMake option of the same name);
+* otherwise the STATS_* macros expand to nothing and cost nothing. When compiled in, every hook first
+* tests one relaxed atomic flag, so a run without --stats pays a predictable branch per event. Each
+* thread counts into its own block, so worker threads never contend; blocks are summed when reported.
+* While enabled, operator new is counted as well.
+*/
+class RunStats 
+{
+public:
+    static const size_t kPhases = static_cast<size_t>(StatsPhase::Print) + 1;
+    static const size_t kCounters = static_cast<size_t>(StatsCounter::AllocatedBytes) + 1;
+
+    /**
+    * @brief Returns true if the build collects statistics (INTERSECTION_STATS).
+    */
+    static constexpr bool compiledIn() 
+    {
+#ifdef INTERSECTION_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+    * @brief Starts or stops collecting. Starting also starts the wall clock of the run.
+    */
+    static void enable(bool on);
+
+    inline static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }  /* Returns true while collecting. */
+
+    /**
+    * @brief Clears every counter, timer and histogram bucket.
+    */
+    static void reset();
+
+    /**
+    * @brief Adds to a counter of the calling thread.
+    */
+    inline static void count(StatsCounter counter, uint64_t amount = 1) 
+    {
+        if (enabled()) 
+        {
+            add(counter, amount);
+        }
+    }
+
+    /**
+    * @brief Records one recursion step that extends a group to the given number of rectangles.
+    */
+    inline static void recordDepth(size_t depth) 
+    {
+        if (enabled()) 
+        {
+            addDepth(depth);
+        }
+    }
+
+    /**
+    * @brief Returns a counter summed over all threads.
+    */
+    static uint64_t total(StatsCounter counter);
+
+    /**
+    * @brief Returns the seconds charged to a phase, summed over all threads.
+    */
+    static double seconds(StatsPhase phase);
+
+    /**
+    * @brief Returns the number of recursion steps recorded at a depth.
+    */
+    static uint64_t depthCount(size_t depth);
+
+    /**
+    * @brief Returns the name of a phase as written in the report (e.g. "pairwise").
+    */
+    static const char* name(StatsPhase phase);
+
+    /**
+    * @brief Writes every statistic as one JSON object.
+    */
+    static void writeJson(std::ostream& out);
+
+    /**
+    * @class ScopedPhase
+    * @brief Charges the time until the end of its scope to a phase, pausing the enclosing phase.
+    */
+    class ScopedPhase 
+    {
+    public:
+        explicit ScopedPhase(StatsPhase phase) : m_active(enabled()) 
+        {
+            if (m_active) 
+            {
+                m_parent = enter(phase);
+            }
+        }
+
+        ~ScopedPhase() 
+        {
+            if (m_active) 
+            {
+                leave(m_parent);
+            }
+        }
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        bool m_active;
+        int m_parent = -1;
+    };
+
+    /**
+    * @brief Returns the number of heap allocations made so far by the calling thread.
+    *
+    * Counted by the replaced operator new whether or not collection is enabled, so tests and the
+    * bench can take the difference around a call to measure its allocations. Always 0 unless
+    * INTERSECTION_STATS is compiled in.
+    */
+    static uint64_t threadAllocations();
+
+    /**
+    * @brief Counts one allocation; called by the replaced operator new.
+    */
+    static void countAllocation(size_t bytes);
+
+private:
+    static std::atomic<bool> s_enabled;
+
+    static void add(StatsCounter counter, uint64_t amount);
+    static void addDepth(size_t depth);
+    static int enter(StatsPhase phase);
+    static void leave(int parent);
+};
+
+#ifdef INTERSECTION_STATS
+#define STATS_CONCAT_INNER(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_INNER(a, b)
+#define STATS_PHASE(phase) RunStats::ScopedPhase STATS_CONCAT(stats_phase_, __LINE__)(phase)
+#define STATS_COUNT(counter) RunStats::count(counter)
+#define STATS_COUNT_N(counter, amount) RunStats::count(counter, amount)
+#define STATS_DEPTH(depth) RunStats::recordDepth(depth)
+#else
+#define STATS_PHASE(phase) ((void)0)
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_COUNT_N(counter, amount) ((void)0)
+#define STATS_DEPTH(depth) ((void)0)
+#endif
+
+#endif // RUN_STATS_HPP
@@ -0,0 +1,519 @@
+#include "SceneServer.h"
+#include "OrderCounter.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace 
+{
+    sockaddr_un socketAddress(const std::string& socket_path) 
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+
+        if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) 
+        {
+            throw std::runtime_error("Invalid socket path: " + socket_path);
+        }
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+        return address;
+    }
+
+    /* Ids is std::vector<int> or the std::pmr::vector<int> of a stored group */
+    template <typename Ids>
+    void putIds(PayloadWriter& writer, const Ids& ids) 
+    {
+        writer.putU32(static_cast<uint32_t>(ids.size()));
+        for (int id : ids) 
+        {
+            writer.putI32(id);
+        }
+    }
+
+    template <typename Ids = std::vector<int>>
+    Ids getIds(PayloadReader& reader) 
+    {
+        Ids ids(reader.getU32());
+        for (int& id : ids) 
+        {
+            id = reader.getI32();
+        }
+        return ids;
+    }
+}
+
+SceneServer::SceneServer(const std::string& socket_path)
+    : m_socketPath(socket_path) 
+{
+    sockaddr_un address = socketAddress(socket_path);
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) 
+    {
+        throw std::runtime_error("Could not create socket: " + std::string(std::strerror(errno)));
+    }
+
+    /* A previous instance that was killed leaves its socket file behind */
+    unlink(socket_path.c_str());
+
+    if (bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listenFd, SOMAXCONN) != 0) 
+    {
+        std::string reason = std::strerror(errno);
+        close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error("Could not listen on " + socket_path + ": " + reason);
+    }
+}
+
+SceneServer::~SceneServer() 
+{
+    for (const Connection& client : m_clients) 
+    {
+        close(client.fd);
+    }
+    if (m_listenFd >= 0) 
+    {
+        close(m_listenFd);
+        unlink(m_socketPath.c_str());
+    }
+}
+
+void SceneServer::run() 
+{
+    std::vector<pollfd> polled;
+    m_running = true;
+
+    while (m_running) 
+    {
+        polled.clear();
+        polled.push_back({m_listenFd, POLLIN, 0});
+        for (const Connection& client : m_clients) 
+        {
+            /* A client with a response in flight is not read until it has taken it */
+            polled.push_back({client.fd, static_cast<short>(client.output.empty() ? POLLIN : POLLOUT), 0});
+        }
+
+        if (poll(polled.data(), polled.size(), -1) < 0) 
+        {
+            if (errno == EINTR) 
+            {
+                continue;
+            }
+            throw std::runtime_error("poll failed: " + std::string(std::strerror(errno)));
+        }
+
+        /* Serve ready clients first; slots of disconnected clients are compacted afterwards */
+        std::vector<Connection> alive;
+        for (size_t i = 1; i < polled.size(); ++i) 
+        {
+            Connection& client = m_clients[i - 1];
+            bool keep = true;
+            if (polled[i].revents != 0 && m_running) 
+            {
+                if ((polled[i].revents & POLLOUT) != 0) 
+                {
+                    keep = flush(client);
+                }
+                else if ((polled[i].revents & POLLIN) != 0) 
+                {
+                    keep = receive(client);
+                }
+                else 
+                {
+                    keep = false;
+                }
+                keep = keep && advance(client);
+            }
+
+            if (keep) 
+            {
+                alive.push_back(std::move(client));
+            }
+            else 
+            {
+                close(client.fd);
+            }
+        }
+        m_clients.swap(alive);
+
+        if ((polled[0].revents & POLLIN) != 0 && m_running) 
+        {
+            int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (fd >= 0) 
+            {
+                Connection client;
+                client.fd = fd;
+                m_clients.push_back(std::move(client));
+            }
+        }
+    }
+}
+
+bool SceneServer::receive(Connection& client) 
+{
+    bool boReturn = true;
+    uint8_t chunk[65536];
+
+    while (true) 
+    {
+        ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+        if (received > 0) 
+        {
+            client.input.insert(client.input.end(), chunk, chunk + received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR) 
+        {
+            continue;
+        }
+        /* Nothing more for now, or the peer closed (0) or failed */
+        boReturn = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    return boReturn;
+}
+
+bool SceneServer::flush(Connection& client) 
+{
+    bool boReturn = true;
+
+    while (client.sent < client.output.size()) 
+    {
+        ssize_t written = send(client.fd, client.output.data() + client.sent, client.output.size() - client.sent, MSG_NOSIGNAL);
+        if (written > 0) 
+        {
+            client.sent += static_cast<size_t>(written);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) 
+        {
+            continue;
+        }
+        boReturn = written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    if (client.sent == client.output.size()) 
+    {
+        client.output.clear();
+        client.sent = 0;
+    }
+    return boReturn;
+}
+
+bool SceneServer::advance(Connection& client) 
+{
+    bool boReturn = true;
+    size_t consumed = 0;
+
+    while (boReturn && client.output.empty() && m_running) 
+    {
+        uint8_t code = 0;
+        uint32_t size = 0;
+        FrameState state = peekFrame(client.input.data() + consumed, client.input.size() - consumed, code, size);
+        if (state == FrameState::Incomplete) 
+        {
+            break;
+        }
+        if (state == FrameState::Oversized) 
+        {
+            boReturn = false;
+            break;
+        }
+
+        const uint8_t* payload = client.input.data() + consumed + SERVER_FRAME_HEADER;
+        std::vector<uint8_t> request(payload, payload + size);
+        consumed += SERVER_FRAME_HEADER + size;
+
+        serveRequest(code, request, client.output);
+        boReturn = flush(client);
+    }
+
+    client.input.erase(client.input.begin(), client.input.begin() + static_cast<std::ptrdiff_t>(consumed));
+    return boReturn;
+}
+
+void SceneServer::serveRequest(uint8_t code, const std::vector<uint8_t>& request, std::vector<uint8_t>& output) 
+{
+    PayloadWriter response;
+    ServerStatus status = ServerStatus::Ok;
+
+    try 
+    {
+        dispatch(static_cast<ServerOpcode>(code), request, response);
+    } 
+    catch (const std::exception& e) 
+    {
+        /* Failed requests are reported to the client; the server and its scenes stay up */
+        response = PayloadWriter();
+        response.putBytes(e.what());
+        status = ServerStatus::Error;
+    }
+
+    if (response.bytes().size() > SERVER_MAX_PAYLOAD) 
+    {
+        /* The client would reject the frame and drop the connection */
+        size_t size = response.bytes().size();
+        response = PayloadWriter();
+        response.putBytes("Response of " + std::to_string(size) + " bytes exceeds the " +
+                          std::to_string(SERVER_MAX_PAYLOAD) + "-byte frame limit.");
+        status = ServerStatus::Error;
+    }
+
+    appendFrame(output, static_cast<uint8_t>(status), response.bytes());
+}
+
+SceneServer::Scene& SceneServer::scene(uint32_t handle) 
+{
+    auto it = m_scenes.find(handle);
+    if (it == m_scenes.end()) 
+    {
+        throw std::runtime_error("Unknown scene " + std::to_string(handle) + ".");
+    }
+    return *it->second;
+}
+
+void SceneServer::dispatch(ServerOpcode opcode, const std::vector<uint8_t>& request, PayloadWriter& response) 
+{
+    PayloadReader reader(request);
+
+    switch (opcode) 
+    {
+        case ServerOpcode::Ping:
+            break;
+
+        case ServerOpcode::Load: 
+        {
+            std::unique_ptr<Scene> loaded(new Scene());
+            std::string path = reader.rest();
+            uint32_t count = 0;
+
+            if (IndexSnapshot::isSnapshot(path)) 
+            {
+                /* Snapshots are queried in place; nothing is parsed or built */
+                loaded->snapshot.reset(new IndexSnapshot(IndexSnapshot::open(path)));
+                count = static_cast<uint32_t>(loaded->snapshot->size());
+            }
+            else 
+            {
+                loaded->finder.loadRectanglesFromFile(path, 0);
+                /* Build the index now so the first query is as fast as the rest */
+                loaded->finder.buildIndex();
+                loaded->loaded = true;
+                count = static_cast<uint32_t>(loaded->finder.rectangles().size());
+            }
+
+            uint32_t handle = m_nextScene++;
+            response.putU32(handle);
+            response.putU32(count);
+            m_scenes[handle] = std::move(loaded);
+            break;
+        }
+
+        case ServerOpcode::Window: 
+        {
+            Scene& target = scene(reader.getU32());
+            int x = reader.getI32();
+            int y = reader.getI32();
+            int w = reader.getI32();
+            int h = reader.getI32();
+            if (w <= 0 || h <= 0) 
+            {
+                throw std::runtime_error("Query window must have positive width and height.");
+            }
+            /* The finder computes the right and bottom edges as int */
+            if (int64_t(x) + w > INT_MAX || int64_t(y) + h > INT_MAX) 
+            {
+                throw std::runtime_error("Query window must end within the int range.");
+            }
+            Rectangle window(-1, x, y, w, h);
+            putIds(response, target.snapshot ? target.snapshot->query(window) : target.finder.queryWindow(window));
+            break;
+        }
+
+        case ServerOpcode::Stab: 
+        {
+            Scene& target = scene(reader.getU32());
+            int x = reader.getI32();
+            int y = reader.getI32();
+            /* The point is queried as the unit cell at (x, y), which must end within the int range */
+            if (x == INT_MAX || y == INT_MAX) 
+            {
+                throw std::runtime_error("Query point must lie below the int maximum.");
+            }
+            putIds(response, target.snapshot ? target.snapshot->stab(x, y) : target.finder.queryPoint(x, y));
+            break;
+        }
+
+        case ServerOpcode::Intersections: 
+        {
+            Scene& target = scene(reader.getU32());
+            if (!target.loaded) 
+            {
+                target.finder.loadRectangles(target.snapshot->rectangles());
+                target.loaded = true;
+            }
+            if (!target.enumerated) 
+            {
+                /* Predict the output size first so one request cannot stall every client */
+                BigUnsigned predicted = OrderCounter::totalIntersections(target.finder.countIntersectionsByOrder());
+                if (predicted > BigUnsigned(SERVER_MAX_RESULTS)) 
+                {
+                    throw std::runtime_error("Refusing to enumerate " + predicted.toString() + " intersections.");
+                }
+                target.finder.processIntersections();
+                target.enumerated = true;
+            }
+
+            const auto& results = target.finder.intersections();
+            response.putU32(static_cast<uint32_t>(results.size()));
+            for (const auto& result : results) 
+            {
+                response.putI32(result.rect.x());
+                response.putI32(result.rect.y());
+                response.putI32(result.rect.w());
+                response.putI32(result.rect.h());
+                putIds(response, result.parent_ids);
+            }
+            break;
+        }
+
+        case ServerOpcode::Unload:
+            if (m_scenes.erase(reader.getU32()) == 0) 
+            {
+                throw std::runtime_error("Unknown scene.");
+            }
+            break;
+
+        case ServerOpcode::Shutdown:
+            m_running = false;
+            break;
+
+        default:
+            throw std::runtime_error("Unknown request code " + std::to_string(static_cast<int>(opcode)) + ".");
+    }
+}
+
+SceneClient::SceneClient(const std::string& socket_path) 
+{
+    sockaddr_un address = socketAddress(socket_path);
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0 || connect(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) 
+    {
+        std::string reason = std::strerror(errno);
+        if (m_fd >= 0) 
+        {
+            close(m_fd);
+        }
+        throw std::runtime_error("Could not connect to " + socket_path + ": " + reason);
+    }
+}
+
+SceneClient::~SceneClient() 
+{
+    close(m_fd);
+}
+
+std::vector<uint8_t> SceneClient::call(ServerOpcode opcode, const PayloadWriter& request) 
+{
+    uint8_t status = 0;
+    std::vector<uint8_t> response;
+
+    if (!writeFrame(m_fd, static_cast<uint8_t>(opcode), request.bytes()) || !readFrame(m_fd, status, response)) 
+    {
+        throw std::runtime_error("Lost connection to the scene server.");
+    }
+    if (status != static_cast<uint8_t>(ServerStatus::Ok)) 
+    {
+        throw std::runtime_error(std::string(response.begin(), response.end()));
+    }
+    return response;
+}
+
+void SceneClient::ping() 
+{
+    call(ServerOpcode::Ping, PayloadWriter());
+}
+
+uint32_t SceneClient::load(const std::string& filename, uint32_t& rectangle_count) 
+{
+    PayloadWriter request;
+    request.putBytes(filename);
+
+    std::vector<uint8_t> response = call(ServerOpcode::Load, request);
+    PayloadReader reader(response);
+    uint32_t handle = reader.getU32();
+    rectangle_count = reader.getU32();
+    return handle;
+}
+
+std::vector<int> SceneClient::window(uint32_t scene, const Rectangle& window) 
+{
+    PayloadWriter request;
+    request.putU32(scene);
+    request.putI32(window.x());
+    request.putI32(window.y());
+    request.putI32(window.w());
+    request.putI32(window.h());
+
+    std::vector<uint8_t> response = call(ServerOpcode::Window, request);
+    PayloadReader reader(response);
+    return getIds(reader);
+}
+
+std::vector<int> SceneClient::stab(uint32_t scene, int x, int y) 
+{
+    PayloadWriter request;
+    request.putU32(scene);
+    request.putI32(x);
+    request.putI32(y);
+
+    std::vector<uint8_t> response = call(ServerOpcode::Stab, request);
+    PayloadReader reader(response);
+    return getIds(reader);
+}
+
+std::vector<IntersectionResult> SceneClient::intersections(uint32_t scene) 
+{
+    PayloadWriter request;
+    request.putU32(scene);
+
+    std::vector<uint8_t> response = call(ServerOpcode::Intersections, request);
+    PayloadReader reader(response);
+
+    uint32_t count = reader.getU32();
+    std::vector<IntersectionResult> results;
+    results.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) 
+    {
+        int x = reader.getI32();
+        int y = reader.getI32();
+        int w = reader.getI32();
+        int h = reader.getI32();
+        results.push_back({Rectangle(-1, x, y, w, h), getIds<std::pmr::vector<int>>(reader)});
+    }
+    return results;
+}
+
+void SceneClient::unload(uint32_t scene) 
+{
+    PayloadWriter request;
+    request.putU32(scene);
+    call(ServerOpcode::Unload, request);
+}
+
+void SceneClient::shutdown() 
+{
+    call(ServerOpcode::Shutdown, PayloadWriter());
+}
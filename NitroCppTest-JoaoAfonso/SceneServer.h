@@ -0,0 +1,189 @@
+#ifndef SCENE_SERVER_HPP
+#define SCENE_SERVER_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include <memory_resource>
+#include "IntersectionFinder.h"
+#include "ServerProtocol.h"
+#include "IndexSnapshot.h"
+
+/**
+* @class SceneServer
+* @brief Long-lived daemon answering scene queries over a Unix domain socket.
+*
+* Scenes are loaded once and kept in memory together with their spatial index, so
+* window and stabbing queries skip process startup, JSON parsing and index construction.
+* Requests use the frame protocol described in ServerProtocol.h. The server is single
+* threaded and multiplexes its clients with poll() over non-blocking sockets: each client
+* has its own input and output buffers, so a client sending part of a frame, or reading
+* its response slowly, never stalls the others. A client's next request is served once
+* its previous response has been sent.
+*/
+class SceneServer 
+{
+private:
+    /**
+    * @struct Scene
+    * @brief A loaded scene and whether its intersections have been enumerated.
+    */
+    struct Scene 
+    {
+        std::pmr::unsynchronized_pool_resource arena; /* IDs of the scene's results; reused across edits, freed at once on unload */
+        IntersectionFinder finder{&arena};  /* Rectangles, index and cached intersection results */
+        bool enumerated = false;       /* True once finder.intersections() is current */
+        std::unique_ptr<IndexSnapshot> snapshot; /* Mapped index when loaded from a snapshot file; answers window and stab queries */
+        bool loaded = false;           /* True once finder holds the rectangles */
+    };
+
+    /**
+    * @struct Connection
+    * @brief A client socket with the bytes received from it and the bytes still to send.
+    */
+    struct Connection 
+    {
+        int fd = -1;
+        std::vector<uint8_t> input;    /* Received bytes not yet consumed as requests */
+        std::vector<uint8_t> output;   /* Response frames not yet fully sent */
+        size_t sent = 0;               /* Bytes of output already sent */
+    };
+
+    std::string m_socketPath;          /* Filesystem path of the listening socket */
+    int m_listenFd = -1;               /* Listening socket */
+    std::vector<Connection> m_clients; /* Connected clients */
+    std::unordered_map<uint32_t, std::unique_ptr<Scene>> m_scenes; /* Scene handle -> scene */
+    uint32_t m_nextScene = 1;          /* Handle assigned to the next loaded scene */
+    bool m_running = false;            /* Cleared by a Shutdown request */
+
+    /**
+    * @brief Reads whatever a client has sent, without blocking.
+    * @return false if the client disconnected or failed and must be closed.
+    */
+    bool receive(Connection& client);
+
+    /**
+    * @brief Sends as much pending output as the socket takes, without blocking.
+    * @return false if the client failed and must be closed.
+    */
+    bool flush(Connection& client);
+
+    /**
+    * @brief Serves the complete requests a client has sent, while its output drains.
+    * @return false if the client failed or sent an oversized frame and must be closed.
+    */
+    bool advance(Connection& client);
+
+    /**
+    * @brief Answers one request, appending the response frame to 'output'.
+    *
+    * A response larger than SERVER_MAX_PAYLOAD, which the client could not read, is replaced
+    * by an error.
+    */
+    void serveRequest(uint8_t code, const std::vector<uint8_t>& request, std::vector<uint8_t>& output);
+
+    /**
+    * @brief Executes one request.
+    * @param opcode Request code.
+    * @param request Request payload.
+    * @param response Receives the response payload.
+    * @throws std::runtime_error on malformed requests or unknown scenes.
+    */
+    void dispatch(ServerOpcode opcode, const std::vector<uint8_t>& request, PayloadWriter& response);
+
+    /**
+    * @brief Looks up a scene handle.
+    * @throws std::runtime_error if no such scene is loaded.
+    */
+    Scene& scene(uint32_t handle);
+
+public:
+    /**
+    * @brief Binds and listens on a Unix domain socket.
+    * @param socket_path Path of the socket file; a stale file at that path is replaced.
+    * @throws std::runtime_error if the socket cannot be created or bound.
+    */
+    explicit SceneServer(const std::string& socket_path);
+
+    /**
+    * @brief Closes every socket and removes the socket file.
+    */
+    ~SceneServer();
+
+    SceneServer(const SceneServer&) = delete;
+    SceneServer& operator=(const SceneServer&) = delete;
+
+    /**
+    * @brief Serves clients until a Shutdown request arrives.
+    * @throws std::runtime_error if polling fails.
+    */
+    void run();
+};
+
+/**
+* @class SceneClient
+* @brief Blocking client for SceneServer.
+*/
+class SceneClient 
+{
+private:
+    int m_fd = -1;  /* Connected socket */
+
+    /**
+    * @brief Sends a request and waits for its response.
+    * @param opcode Request code.
+    * @param request Request payload.
+    * @return The response payload.
+    * @throws std::runtime_error on connection failures or error responses.
+    */
+    std::vector<uint8_t> call(ServerOpcode opcode, const PayloadWriter& request);
+
+public:
+    /**
+    * @brief Connects to a server.
+    * @param socket_path Path of the server socket.
+    * @throws std::runtime_error if the connection fails.
+    */
+    explicit SceneClient(const std::string& socket_path);
+
+    ~SceneClient();
+
+    SceneClient(const SceneClient&) = delete;
+    SceneClient& operator=(const SceneClient&) = delete;
+
+    void ping();
+
+    /**
+    * @brief Loads a JSON scene file, without the rectangle limit, or maps an index snapshot on the server.
+    * @param filename Path as seen by the server.
+    * @param rectangle_count Receives the number of rectangles loaded.
+    * @return Handle of the new scene.
+    */
+    uint32_t load(const std::string& filename, uint32_t& rectangle_count);
+
+    /**
+    * @brief Returns the sorted IDs of the rectangles overlapping a window.
+    */
+    std::vector<int> window(uint32_t scene, const Rectangle& window);
+
+    /**
+    * @brief Returns the sorted IDs of the rectangles containing a point.
+    */
+    std::vector<int> stab(uint32_t scene, int x, int y);
+
+    /**
+    * @brief Returns every intersection group of a scene, enumerated on the first request.
+    */
+    std::vector<IntersectionResult> intersections(uint32_t scene);
+
+    void unload(uint32_t scene);
+
+    /**
+    * @brief Asks the server to stop after answering.
+    */
+    void shutdown();
+};
+
+#endif // SCENE_SERVER_HPP
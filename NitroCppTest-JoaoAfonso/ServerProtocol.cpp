@@ -0,0 +1,160 @@
+#include "ServerProtocol.h"
+
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace 
+{
+    bool writeAll(int fd, const void* data, size_t size) 
+    {
+        const char* cursor = static_cast<const char*>(data);
+        while (size > 0) 
+        {
+            ssize_t written = send(fd, cursor, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) 
+            {
+                continue;
+            }
+            if (written <= 0) 
+            {
+                return false;
+            }
+            cursor += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readAll(int fd, void* data, size_t size) 
+    {
+        char* cursor = static_cast<char*>(data);
+        while (size > 0) 
+        {
+            ssize_t received = recv(fd, cursor, size, 0);
+            if (received < 0 && errno == EINTR) 
+            {
+                continue;
+            }
+            if (received <= 0) 
+            {
+                return false;
+            }
+            cursor += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+}
+
+void PayloadWriter::putU32(uint32_t value) 
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(value));
+}
+
+void PayloadWriter::putI32(int32_t value) 
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(value));
+}
+
+void PayloadWriter::putBytes(const std::string& bytes) 
+{
+    m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+}
+
+void PayloadReader::take(void* target, size_t size) 
+{
+    if (m_bytes.size() - m_offset < size) 
+    {
+        throw std::runtime_error("Truncated message payload.");
+    }
+    std::memcpy(target, m_bytes.data() + m_offset, size);
+    m_offset += size;
+}
+
+uint32_t PayloadReader::getU32() 
+{
+    uint32_t value = 0;
+    take(&value, sizeof(value));
+    return value;
+}
+
+int32_t PayloadReader::getI32() 
+{
+    int32_t value = 0;
+    take(&value, sizeof(value));
+    return value;
+}
+
+std::string PayloadReader::rest() 
+{
+    std::string bytes(m_bytes.begin() + static_cast<std::ptrdiff_t>(m_offset), m_bytes.end());
+    m_offset = m_bytes.size();
+    return bytes;
+}
+
+void appendFrame(std::vector<uint8_t>& buffer, uint8_t code, const std::vector<uint8_t>& payload) 
+{
+    uint32_t size = static_cast<uint32_t>(payload.size());
+    const uint8_t* size_bytes = reinterpret_cast<const uint8_t*>(&size);
+    buffer.push_back(code);
+    buffer.insert(buffer.end(), size_bytes, size_bytes + sizeof(size));
+    buffer.insert(buffer.end(), payload.begin(), payload.end());
+}
+
+FrameState peekFrame(const uint8_t* data, size_t size, uint8_t& code, uint32_t& payload_size) 
+{
+    FrameState state = FrameState::Incomplete;
+
+    if (size >= SERVER_FRAME_HEADER) 
+    {
+        code = data[0];
+        std::memcpy(&payload_size, data + 1, sizeof(payload_size));
+
+        if (payload_size > SERVER_MAX_PAYLOAD) 
+        {
+            state = FrameState::Oversized;
+        }
+        else if (size - SERVER_FRAME_HEADER >= payload_size) 
+        {
+            state = FrameState::Complete;
+        }
+    }
+
+    return state;
+}
+
+bool writeFrame(int fd, uint8_t code, const std::vector<uint8_t>& payload) 
+{
+    /* Header and payload go out in one buffer so small requests cost a single system call */
+    std::vector<uint8_t> frame;
+    frame.reserve(SERVER_FRAME_HEADER + payload.size());
+    appendFrame(frame, code, payload);
+
+    return writeAll(fd, frame.data(), frame.size());
+}
+
+bool readFrame(int fd, uint8_t& code, std::vector<uint8_t>& payload) 
+{
+    bool boReturn = false;
+    uint8_t header[SERVER_FRAME_HEADER];
+
+    if (readAll(fd, header, sizeof(header))) 
+    {
+        uint32_t size = 0;
+        std::memcpy(&size, header + 1, sizeof(size));
+
+        if (size <= SERVER_MAX_PAYLOAD) 
+        {
+            code = header[0];
+            payload.resize(size);
+            boReturn = size == 0 || readAll(fd, payload.data(), size);
+        }
+    }
+
+    return boReturn;
+}
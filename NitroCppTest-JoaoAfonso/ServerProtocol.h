@@ -0,0 +1,142 @@
+#ifndef SERVER_PROTOCOL_HPP
+#define SERVER_PROTOCOL_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/* Largest payload accepted in either direction */
+#define SERVER_MAX_PAYLOAD (64u * 1024u * 1024u)
+
+/* Largest number of intersection groups the server enumerates for one scene */
+#define SERVER_MAX_RESULTS 1000000u
+
+/* Bytes of a frame header: the code and the payload size */
+#define SERVER_FRAME_HEADER 5u
+
+/**
+* @brief Request codes of the scene server protocol.
+*
+* Every message is a frame: a 1-byte code, a 4-byte payload size and the payload. Requests
+* carry a ServerOpcode, responses a ServerStatus. Integers are in host byte order, since
+* the protocol only runs over a local Unix domain socket.
+*
+* Payloads (requests -> responses):
+* - Ping: empty -> empty.
+* - Load: path of a JSON scene or index snapshot -> u32 scene, u32 rectangle count.
+* - Window: u32 scene, i32 x, y, w, h (w, h > 0, x + w and y + h at most INT_MAX) -> u32 n, n x i32 ID.
+* - Stab: u32 scene, i32 x, y (below INT_MAX) -> u32 n, n x i32 ID.
+* - Intersections: u32 scene -> u32 n, n x (i32 x, y, w, h, u32 k, k x i32 ID).
+* - Unload: u32 scene -> empty.
+* - Shutdown: empty -> empty, then the server stops.
+* Errors answer with ServerStatus::Error and the message text as payload.
+*/
+enum class ServerOpcode : uint8_t 
+{
+    Ping = 0,
+    Load = 1,
+    Window = 2,
+    Stab = 3,
+    Intersections = 4,
+    Unload = 5,
+    Shutdown = 6
+};
+
+/**
+* @brief Response codes of the scene server protocol.
+*/
+enum class ServerStatus : uint8_t 
+{
+    Ok = 0,
+    Error = 1
+};
+
+/**
+* @class PayloadWriter
+* @brief Appends fixed-size fields to a frame payload.
+*/
+class PayloadWriter 
+{
+private:
+    std::vector<uint8_t> m_bytes;
+
+public:
+    void putU32(uint32_t value);
+    void putI32(int32_t value);
+    void putBytes(const std::string& bytes);
+
+    inline const std::vector<uint8_t>& bytes() const { return m_bytes; }  /* Returns the payload built so far. */
+};
+
+/**
+* @class PayloadReader
+* @brief Reads fixed-size fields from a frame payload.
+*/
+class PayloadReader 
+{
+private:
+    const std::vector<uint8_t>& m_bytes;
+    size_t m_offset = 0;
+
+    void take(void* target, size_t size);
+
+public:
+    explicit PayloadReader(const std::vector<uint8_t>& bytes): m_bytes(bytes) {}
+
+    /**
+    * @brief Reads the next field.
+    * @throws std::runtime_error if the payload is too short.
+    */
+    uint32_t getU32();
+    int32_t getI32();
+
+    /**
+    * @brief Returns every byte not read yet.
+    */
+    std::string rest();
+};
+
+/**
+* @brief What a buffer of received bytes starts with.
+*/
+enum class FrameState 
+{
+    Incomplete,  /* Part of a frame; more bytes are needed */
+    Complete,    /* A whole frame */
+    Oversized    /* A header announcing more than SERVER_MAX_PAYLOAD bytes */
+};
+
+/**
+* @brief Appends one frame (header and payload) to a buffer.
+*/
+void appendFrame(std::vector<uint8_t>& buffer, uint8_t code, const std::vector<uint8_t>& payload);
+
+/**
+* @brief Checks whether received bytes start with a whole frame, without consuming them.
+* @param data Received bytes.
+* @param size Number of received bytes.
+* @param code Receives the code once the header is complete.
+* @param payload_size Receives the payload size once the header is complete.
+*/
+FrameState peekFrame(const uint8_t* data, size_t size, uint8_t& code, uint32_t& payload_size);
+
+/**
+* @brief Writes one frame, retrying on partial writes.
+* @param fd Connected socket.
+* @param code Opcode or status byte.
+* @param payload Frame payload.
+* @return true on success; false if the peer disconnected or an error occurred.
+*/
+bool writeFrame(int fd, uint8_t code, const std::vector<uint8_t>& payload);
+
+/**
+* @brief Reads one frame, retrying on partial reads.
+* @param fd Connected socket.
+* @param code Receives the opcode or status byte.
+* @param payload Receives the frame payload.
+* @return true on success; false on disconnect, error or an oversized frame.
+*/
+bool readFrame(int fd, uint8_t& code, std::vector<uint8_t>& payload);
+
+#endif // SERVER_PROTOCOL_HPP
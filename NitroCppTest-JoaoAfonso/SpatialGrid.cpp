@@ -0,0 +1,148 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace 
+{
+    /* Grid coordinate of a position, rounding towards negative infinity */
+    inline int64_t cellOf(int64_t position, int cell_size) 
+    {
+        return position >= 0 ? position / cell_size : -((-position + cell_size - 1) / cell_size);
+    }
+
+    inline int64_t cellKey(int64_t cx, int64_t cy) 
+    {
+        return static_cast<int64_t>((static_cast<uint64_t>(cx) << 32) ^ static_cast<uint32_t>(cy));
+    }
+}
+
+SpatialGrid::SpatialGrid(int cell_size): m_cellSize(cell_size) 
+{
+    if (cell_size <= 0) 
+    {
+        throw std::invalid_argument("Spatial grid cell size must be positive.");
+    }
+}
+
+uint64_t SpatialGrid::cellCount(const Rectangle& rect) const 
+{
+    /* The right and bottom edges are exclusive, so the last touched cell holds right - 1 */
+    const int64_t columns = cellOf(static_cast<int64_t>(rect.x()) + rect.w() - 1, m_cellSize) - cellOf(rect.x(), m_cellSize) + 1;
+    const int64_t rows = cellOf(static_cast<int64_t>(rect.y()) + rect.h() - 1, m_cellSize) - cellOf(rect.y(), m_cellSize) + 1;
+    return static_cast<uint64_t>(columns) * static_cast<uint64_t>(rows);
+}
+
+template <typename Visitor>
+void SpatialGrid::forEachCell(const Rectangle& rect, Visitor visit) const 
+{
+    const int64_t cx0 = cellOf(rect.x(), m_cellSize);
+    const int64_t cy0 = cellOf(rect.y(), m_cellSize);
+    const int64_t cx1 = cellOf(static_cast<int64_t>(rect.x()) + rect.w() - 1, m_cellSize);
+    const int64_t cy1 = cellOf(static_cast<int64_t>(rect.y()) + rect.h() - 1, m_cellSize);
+
+    for (int64_t cx = cx0; cx <= cx1; ++cx) 
+    {
+        for (int64_t cy = cy0; cy <= cy1; ++cy) 
+        {
+            visit(cellKey(cx, cy));
+        }
+    }
+}
+
+void SpatialGrid::insert(const Rectangle& rect) 
+{
+    erase(rect.id());
+
+    m_rectangles.emplace(rect.id(), rect);
+
+    if (cellCount(rect) > SPATIAL_GRID_MAX_CELLS_PER_RECTANGLE) 
+    {
+        m_oversized.push_back(rect.id());
+        return;
+    }
+
+    forEachCell(rect, [&](int64_t key) {
+        m_cells[key].push_back(rect.id());
+    });
+}
+
+bool SpatialGrid::erase(int id) 
+{
+    bool boReturn = false;
+    auto found = m_rectangles.find(id);
+
+    if (found != m_rectangles.end()) 
+    {
+        auto oversized = std::find(m_oversized.begin(), m_oversized.end(), id);
+        if (oversized != m_oversized.end()) 
+        {
+            m_oversized.erase(oversized);
+        }
+        else 
+        {
+            forEachCell(found->second, [&](int64_t key) {
+                auto cell = m_cells.find(key);
+                auto& ids = cell->second;
+                ids.erase(std::find(ids.begin(), ids.end(), id));
+                if (ids.empty()) 
+                {
+                    m_cells.erase(cell);
+                }
+            });
+        }
+
+        m_rectangles.erase(found);
+        boReturn = true;
+    }
+
+    return boReturn;
+}
+
+void SpatialGrid::clear() 
+{
+    m_cells.clear();
+    m_rectangles.clear();
+    m_oversized.clear();
+}
+
+std::vector<int> SpatialGrid::query(const Rectangle& window) const 
+{
+    std::vector<int> ids = m_oversized;
+
+    if (cellCount(window) > m_cells.size()) 
+    {
+        /* Windows larger than the occupied part of the grid: visiting the occupied cells is cheaper */
+        for (const auto& cell : m_cells) 
+        {
+            ids.insert(ids.end(), cell.second.begin(), cell.second.end());
+        }
+    }
+    else 
+    {
+        forEachCell(window, [&](int64_t key) {
+            auto cell = m_cells.find(key);
+            if (cell != m_cells.end()) 
+            {
+                ids.insert(ids.end(), cell->second.begin(), cell->second.end());
+            }
+        });
+    }
+
+    /* Rectangles spanning several cells are reported once */
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    Rectangle overlap(-1, 0, 0, 0, 0);
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [&](int id) {
+        return !Rectangle::calculate_intersection(m_rectangles.at(id), window, overlap);
+    }), ids.end());
+
+    return ids;
+}
+
+const Rectangle* SpatialGrid::find(int id) const 
+{
+    auto found = m_rectangles.find(id);
+    return found != m_rectangles.end() ? &found->second : nullptr;
+}
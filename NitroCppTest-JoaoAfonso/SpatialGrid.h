@@ -0,0 +1,84 @@
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Rectangle.h"
+
+/* Default side length of a grid cell, in coordinate units */
+#define SPATIAL_GRID_DEFAULT_CELL_SIZE 64
+
+/* Rectangles touching more cells than this are kept in a separate list scanned by every query */
+#define SPATIAL_GRID_MAX_CELLS_PER_RECTANGLE 256
+
+/**
+* @class SpatialGrid
+* @brief Dynamic uniform-grid index supporting insertion, removal and window queries.
+*
+* Every rectangle is registered in each grid cell it touches, in a hash map keyed by cell
+* coordinates, so only occupied cells use memory. Updates and queries touch the cells under
+* the rectangle or window, which keeps their cost proportional to the local neighbourhood
+* rather than the size of the scene. Rectangles much larger than a cell are not split over
+* the grid; they are kept aside and checked by every query instead.
+*/
+class SpatialGrid 
+{
+private:
+    int m_cellSize;                                      /* Side length of a cell. */
+    std::unordered_map<int64_t, std::vector<int>> m_cells; /* Cell key -> IDs of rectangles touching the cell. */
+    std::unordered_map<int, Rectangle> m_rectangles;     /* ID -> indexed rectangle. */
+    std::vector<int> m_oversized;                        /* IDs of rectangles too large to register per cell. */
+
+    /* Number of cells touched by a rectangle */
+    uint64_t cellCount(const Rectangle& rect) const;
+
+    /* Calls visit(key) for every cell touched by a rectangle */
+    template <typename Visitor>
+    void forEachCell(const Rectangle& rect, Visitor visit) const;
+
+public:
+    /**
+    * @brief Constructs an empty grid.
+    * @param cell_size Side length of a grid cell; must be positive.
+    * @throws std::invalid_argument if cell_size is not positive.
+    */
+    explicit SpatialGrid(int cell_size = SPATIAL_GRID_DEFAULT_CELL_SIZE);
+
+    /**
+    * @brief Indexes a rectangle under its ID, replacing any rectangle with the same ID.
+    * @param rect Rectangle to index.
+    */
+    void insert(const Rectangle& rect);
+
+    /**
+    * @brief Removes the rectangle with the given ID.
+    * @param id ID of the rectangle.
+    * @return true if it was indexed and has been removed; false otherwise.
+    */
+    bool erase(int id);
+
+    /**
+    * @brief Removes every rectangle.
+    */
+    void clear();
+
+    /**
+    * @brief Window query: IDs of indexed rectangles sharing a region of positive area with the window.
+    * @param window Query rectangle.
+    * @return std::vector<int> Matching IDs in ascending order.
+    */
+    std::vector<int> query(const Rectangle& window) const;
+
+    /**
+    * @brief Looks up an indexed rectangle.
+    * @param id ID of the rectangle.
+    * @return const Rectangle* The rectangle, or nullptr if the ID is not indexed.
+    */
+    const Rectangle* find(int id) const;
+
+    inline size_t size() const { return m_rectangles.size(); }  /* Returns the number of indexed rectangles. */
+    inline int cellSize() const { return m_cellSize; }          /* Returns the side length of a cell. */
+};
+
+#endif // SPATIAL_GRID_HPP
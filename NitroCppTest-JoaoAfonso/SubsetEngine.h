@@ -0,0 +1,243 @@
+#ifndef SUBSET_ENGINE_HPP
+#define SUBSET_ENGINE_HPP
+
+#include <climits>
+#include <cstddef>
+#include <algorithm>
+#include "Rectangle.h"
+#include "RunStats.h"
+
+/* Largest scene the subset engine is instantiated for: its tables hold 2^N entries, 16 KiB at the default MAX_RECTANGLES */
+#define SUBSET_ENGINE_MAX_SIZE 10u
+
+/* The table is built when at least 1 in SUBSET_ENGINE_DENSITY pairs overlap; sparser scenes are searched instead */
+#define SUBSET_ENGINE_DENSITY 2u
+
+/**
+* @class SubsetEngine
+* @brief Enumerates the intersecting groups of a scene of exactly N rectangles, N known at compile
+* time, with fixed-size arrays on the stack: enumerating allocates nothing.
+*
+* The N(N-1)/2 pairs are tested first, giving each rectangle a bitmask of the rectangles it overlaps.
+* Dense scenes then fill a table of the common regions of all 2^N subsets by dynamic programming:
+* the subsets holding rectangle b as their highest member are the 2^b subsets of rectangles 0..b-1,
+* each narrowed by rectangle b. That inner loop runs over contiguous masks with one rectangle held
+* fixed, so the compiler unrolls the N steps and vectorizes the max/min across masks. An empty
+* region stays empty when narrowed, so no flag is needed. In sparse scenes most of the table would
+* be empty, so the groups are searched instead, extending each one only by the later rectangles
+* overlapping all of its members.
+*
+* Both ways test a region with the arithmetic of Rectangle::calculate_intersection.
+*/
+template <size_t N>
+class SubsetEngine 
+{
+    static_assert(N >= 2 && N <= SUBSET_ENGINE_MAX_SIZE, "SubsetEngine covers 2 to SUBSET_ENGINE_MAX_SIZE rectangles");
+
+public:
+    static const size_t kSubsets = size_t(1) << N;
+
+    /**
+    * @brief Reports every group of 2 or more rectangles with a common region.
+    *
+    * Groups come in the order of the depth-first search of IntersectionFinder::processIntersections():
+    * by lowest index, each group followed by its extensions by later rectangles.
+    *
+    * @param rects The N rectangles.
+    * @param record Called as record(region, ids, count) for every group, 'ids' holding the 'count' IDs
+    *               by ascending index.
+    * @return Number of groups reported.
+    */
+    template <typename Record>
+    static size_t enumerate(const Rectangle* rects, Record&& record) 
+    {
+        /* Overlap bitmask of every rectangle, from the N(N-1)/2 pairs */
+        size_t overlaps[N] = {};
+        size_t pairs = 0;
+        for (size_t i = 0; i < N; ++i) 
+        {
+            for (size_t j = i + 1; j < N; ++j) 
+            {
+                if (std::min(rects[i].right(), rects[j].right()) - std::max(rects[i].x(), rects[j].x()) > 0 &&
+                    std::min(rects[i].bottom(), rects[j].bottom()) - std::max(rects[i].y(), rects[j].y()) > 0) 
+                {
+                    overlaps[i] |= size_t(1) << j;
+                    overlaps[j] |= size_t(1) << i;
+                    ++pairs;
+                }
+            }
+        }
+        STATS_COUNT_N(StatsCounter::IntersectionTests, N * (N - 1) / 2);
+
+        size_t found = 0;
+        if (pairs * SUBSET_ENGINE_DENSITY >= N * (N - 1) / 2) 
+        {
+            found = enumerateTable(rects, record);
+        }
+        else 
+        {
+            found = enumerateSparse(rects, overlaps, record);
+        }
+        STATS_COUNT_N(StatsCounter::IntersectionHits, found);
+        return found;
+    }
+
+private:
+    /**
+    * @brief Fills the table of all subsets, then reads the groups off it in search order.
+    */
+    template <typename Record>
+    static size_t enumerateTable(const Rectangle* rects, Record&& record) 
+    {
+        alignas(64) int left[kSubsets];
+        alignas(64) int top[kSubsets];
+        alignas(64) int right[kSubsets];
+        alignas(64) int bottom[kSubsets];
+
+        /* The empty subset covers the plane */
+        left[0] = INT_MIN;
+        top[0] = INT_MIN;
+        right[0] = INT_MAX;
+        bottom[0] = INT_MAX;
+
+        for (size_t bit = 0; bit < N; ++bit) 
+        {
+            const size_t half = size_t(1) << bit;
+            const int x = rects[bit].x();
+            const int y = rects[bit].y();
+            const int r = rects[bit].right();
+            const int b = rects[bit].bottom();
+
+            for (size_t mask = 0; mask < half; ++mask) 
+            {
+                left[half + mask] = std::max(left[mask], x);
+                top[half + mask] = std::max(top[mask], y);
+                right[half + mask] = std::min(right[mask], r);
+                bottom[half + mask] = std::min(bottom[mask], b);
+            }
+        }
+        STATS_COUNT_N(StatsCounter::IntersectionTests, kSubsets - 1 - N - N * (N - 1) / 2);
+
+        /* Depth-first over ascending index sequences, looking every group up in the tables */
+        size_t found = 0;
+        int ids[N];
+        size_t masks[N];
+        size_t next[N];
+
+        for (size_t first = 0; first + 1 < N; ++first) 
+        {
+            size_t depth = 0;
+            ids[0] = rects[first].id();
+            masks[0] = size_t(1) << first;
+            next[0] = first + 1;
+
+            while (true) 
+            {
+                if (next[depth] >= N) 
+                {
+                    if (depth == 0) 
+                    {
+                        break;
+                    }
+                    --depth;
+                    continue;
+                }
+
+                const size_t index = next[depth]++;
+                const size_t mask = masks[depth] | (size_t(1) << index);
+                const int w = right[mask] - left[mask];
+                const int h = bottom[mask] - top[mask];
+
+                if (w > 0 && h > 0) 
+                {
+                    ids[depth + 1] = rects[index].id();
+                    record(Rectangle(-1, left[mask], top[mask], w, h), ids, depth + 2);
+                    ++found;
+
+                    ++depth;
+                    masks[depth] = mask;
+                    next[depth] = index + 1;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    /**
+    * @brief Searches the groups depth first, extending each by the later rectangles overlapping all its members.
+    * @param overlaps Bitmask of the rectangles each one overlaps.
+    */
+    template <typename Record>
+    static size_t enumerateSparse(const Rectangle* rects, const size_t* overlaps, Record&& record) 
+    {
+        size_t found = 0;
+        int ids[N];
+        int left[N];
+        int top[N];
+        int right[N];
+        int bottom[N];
+        size_t candidates[N];   /* Later rectangles overlapping every member of the group */
+        size_t next[N];
+
+        for (size_t first = 0; first + 1 < N; ++first) 
+        {
+            size_t depth = 0;
+            ids[0] = rects[first].id();
+            left[0] = rects[first].x();
+            top[0] = rects[first].y();
+            right[0] = rects[first].right();
+            bottom[0] = rects[first].bottom();
+            candidates[0] = overlaps[first] >> (first + 1) << (first + 1);
+            next[0] = first + 1;
+
+            while (true) 
+            {
+                while (next[depth] < N && (candidates[depth] >> next[depth] & 1) == 0) 
+                {
+                    ++next[depth];
+                }
+                if (next[depth] >= N) 
+                {
+                    if (depth == 0) 
+                    {
+                        break;
+                    }
+                    --depth;
+                    continue;
+                }
+
+                const size_t index = next[depth]++;
+                const int l = std::max(left[depth], rects[index].x());
+                const int t = std::max(top[depth], rects[index].y());
+                const int r = std::min(right[depth], rects[index].right());
+                const int b = std::min(bottom[depth], rects[index].bottom());
+
+                /* Pairs are known to overlap; only a group of 3 or more needs the test */
+                if (depth > 0) 
+                {
+                    STATS_COUNT(StatsCounter::IntersectionTests);
+                }
+
+                if (r - l > 0 && b - t > 0) 
+                {
+                    ids[depth + 1] = rects[index].id();
+                    record(Rectangle(-1, l, t, r - l, b - t), ids, depth + 2);
+                    ++found;
+
+                    ++depth;
+                    left[depth] = l;
+                    top[depth] = t;
+                    right[depth] = r;
+                    bottom[depth] = b;
+                    candidates[depth] = candidates[depth - 1] & overlaps[index];
+                    next[depth] = index + 1;
+                }
+            }
+        }
+
+        return found;
+    }
+};
+
+#endif // SUBSET_ENGINE_HPP
@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads) 
+{
+    if (threads == 0) 
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(threads);
+    for (size_t worker = 0; worker < threads; ++worker) 
+    {
+        m_workers.emplace_back(&ThreadPool::work, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() 
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) 
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& task) 
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next.store(0, std::memory_order_relaxed);
+    m_active = m_workers.size();
+    m_error = nullptr;
+    ++m_generation;
+    m_wake.notify_all();
+
+    m_done.wait(lock, [this]() { return m_active == 0; });
+    m_task = nullptr;
+
+    if (m_error) 
+    {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void ThreadPool::work(size_t worker) 
+{
+    uint64_t seen = 0;
+    TRACE_THREAD_NAME("worker " + std::to_string(worker));
+
+    for (;;) 
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen]() { return m_stopping || m_generation != seen; });
+            if (m_stopping) 
+            {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        /* The loop parameters were published under the mutex, so they are visible here */
+        for (size_t index = m_next.fetch_add(1); index < m_count; index = m_next.fetch_add(1)) 
+        {
+            try 
+            {
+                (*m_task)(index, worker);
+            } 
+            catch (...) 
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) 
+                {
+                    m_error = std::current_exception();
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0) 
+            {
+                m_done.notify_all();
+            }
+        }
+    }
+}
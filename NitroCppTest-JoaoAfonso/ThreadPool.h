@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+
+/**
+* @class ThreadPool
+* @brief Fixed set of worker threads that run indexed loops.
+*
+* Workers are started once and parked between loops, so short jobs do not pay for thread
+* creation. Indices are handed out one at a time through an atomic counter, which balances
+* jobs of very different sizes. A loop must not be started from inside a running task, and
+* only one thread may start loops at a time.
+*/
+class ThreadPool 
+{
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;       /* Signals a new loop or shutdown to the workers */
+    std::condition_variable m_done;       /* Signals the caller that every worker finished the loop */
+    const std::function<void(size_t, size_t)>* m_task = nullptr; /* Body of the running loop */
+    size_t m_count = 0;                   /* Number of indices in the running loop */
+    std::atomic<size_t> m_next{0};        /* Next index to hand out */
+    size_t m_active = 0;                  /* Workers still inside the running loop */
+    uint64_t m_generation = 0;            /* Incremented for every loop */
+    bool m_stopping = false;
+    std::exception_ptr m_error;           /* First exception thrown by the running loop */
+
+    /**
+    * @brief Worker main loop.
+    * @param worker Index of the worker, passed on to the tasks.
+    */
+    void work(size_t worker);
+
+public:
+    /**
+    * @brief Starts the workers.
+    * @param threads Number of workers; 0 uses the hardware concurrency.
+    */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+    * @brief Stops and joins the workers.
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    inline size_t size() const { return m_workers.size(); }  /* Returns the number of workers. */
+
+    /**
+    * @brief Runs task(index, worker) for every index in [0, count) and waits for all of them.
+    *
+    * Calls with the same worker index never overlap, so tasks may keep per-worker state
+    * in a vector of size() entries.
+    *
+    * @param count Number of indices.
+    * @param task Loop body.
+    * @throws The first exception thrown by a task, after every index has been processed.
+    */
+    void parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task);
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,150 @@
+#include "TraceRecorder.h"
+#include "json.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+namespace 
+{
+    struct Span 
+    {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+
+    /* Ring of one thread. Only the owning thread writes; the writer of the trace reads after it finished */
+    struct ThreadTrace 
+    {
+        std::unique_ptr<Span[]> ring{new Span[TRACE_RING_CAPACITY]};
+        std::atomic<uint64_t> written{0};    /* Spans ever recorded; the ring holds the last TRACE_RING_CAPACITY */
+        size_t tid = 0;
+        std::string name;
+    };
+
+    /* Rings stay registered after their thread exits, so the spans of finished workers are still written */
+    struct Registry 
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadTrace>> threads;
+        std::atomic<uint64_t> start_ns{0};
+    };
+
+    Registry& registry() 
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    /* Registers the calling thread on its first span; the only step that locks or allocates */
+    ThreadTrace& local() 
+    {
+        thread_local ThreadTrace* trace = nullptr;
+        if (trace == nullptr) 
+        {
+            std::unique_ptr<ThreadTrace> created(new ThreadTrace);
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            created->tid = shared.threads.size() + 1;
+            trace = created.get();
+            shared.threads.push_back(std::move(created));
+        }
+        return *trace;
+    }
+}
+
+void TraceRecorder::enable(bool on) 
+{
+    if (on) 
+    {
+        registry().start_ns.store(now(), std::memory_order_relaxed);
+    }
+    s_enabled.store(on, std::memory_order_relaxed);
+}
+
+uint64_t TraceRecorder::now() 
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void TraceRecorder::record(const char* name, uint64_t start_ns, uint64_t duration_ns) 
+{
+    ThreadTrace& trace = local();
+    uint64_t count = trace.written.load(std::memory_order_relaxed);
+    trace.ring[count % TRACE_RING_CAPACITY] = {name, start_ns, duration_ns};
+    trace.written.store(count + 1, std::memory_order_release);
+}
+
+void TraceRecorder::nameThread(const std::string& name) 
+{
+    local().name = name;
+}
+
+size_t TraceRecorder::spanCount() 
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    size_t count = 0;
+    for (const auto& trace : shared.threads) 
+    {
+        count += static_cast<size_t>(std::min<uint64_t>(trace->written.load(std::memory_order_acquire), TRACE_RING_CAPACITY));
+    }
+    return count;
+}
+
+void TraceRecorder::reset() 
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (const auto& trace : shared.threads) 
+    {
+        trace->written.store(0, std::memory_order_release);
+    }
+    shared.start_ns.store(now(), std::memory_order_relaxed);
+}
+
+void TraceRecorder::writeJson(std::ostream& out) 
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    const uint64_t origin = shared.start_ns.load(std::memory_order_relaxed);
+    const char* separator = "\n";
+    char number[64];
+
+    out << "{\"traceEvents\": [";
+    for (const auto& trace : shared.threads) 
+    {
+        if (!trace->name.empty()) 
+        {
+            out << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << trace->tid
+                << ", \"args\": {\"name\": " << nlohmann::json(trace->name).dump() << "}}";
+            separator = ",\n";
+        }
+
+        uint64_t written = trace->written.load(std::memory_order_acquire);
+        uint64_t first = written > TRACE_RING_CAPACITY ? written - TRACE_RING_CAPACITY : 0;
+        for (uint64_t i = first; i < written; ++i) 
+        {
+            const Span& span = trace->ring[i % TRACE_RING_CAPACITY];
+            if (span.start_ns < origin) 
+            {
+                continue;
+            }
+
+            /* Chrome trace timestamps are microseconds; keep nanosecond precision as decimals */
+            std::snprintf(number, sizeof(number), "\"ts\": %.3f, \"dur\": %.3f", (span.start_ns - origin) / 1000.0,
+                          span.duration_ns / 1000.0);
+            out << separator << "{\"name\": \"" << span.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << trace->tid
+                << ", " << number << "}";
+            separator = ",\n";
+        }
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+}
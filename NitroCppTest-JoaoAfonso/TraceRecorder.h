@@ -0,0 +1,119 @@
+#ifndef TRACE_RECORDER_HPP
+#define TRACE_RECORDER_HPP
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+/* Spans kept per thread; once full, a thread's ring overwrites its oldest spans */
+#define TRACE_RING_CAPACITY 65536u
+
+/**
+* @class TraceRecorder
+* @brief Records scoped spans of every thread and writes them in Chrome trace-event JSON (--trace),
+* viewable in Perfetto or chrome://tracing.
+*
+* Each thread appends to its own fixed-size ring buffer, so recording takes no lock and never
+* allocates after the thread's first span. Span names must be string literals: only the pointer
+* is stored. Recording is compiled in only when INTERSECTION_TRACE is defined (the CMake option of
+* the same name); otherwise the TRACE_* macros expand to nothing.
+*/
+class TraceRecorder 
+{
+public:
+    /**
+    * @brief Returns true if the build records spans (INTERSECTION_TRACE).
+    */
+    static constexpr bool compiledIn() 
+    {
+#ifdef INTERSECTION_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+    * @brief Starts or stops recording. Starting sets time zero of the trace.
+    */
+    static void enable(bool on);
+
+    inline static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }  /* Returns true while recording. */
+
+    /**
+    * @brief Appends a finished span to the calling thread's ring.
+    * @param name Span name; a string literal.
+    * @param start_ns Start, in steady-clock nanoseconds (see now()).
+    * @param duration_ns Duration in nanoseconds.
+    */
+    static void record(const char* name, uint64_t start_ns, uint64_t duration_ns);
+
+    /**
+    * @brief Names the calling thread in the trace (e.g. "worker 3").
+    */
+    static void nameThread(const std::string& name);
+
+    /**
+    * @brief Returns the steady clock in nanoseconds.
+    */
+    static uint64_t now();
+
+    /**
+    * @brief Returns the number of spans currently held, over all threads.
+    */
+    static size_t spanCount();
+
+    /**
+    * @brief Drops every recorded span. Must not run while other threads record.
+    */
+    static void reset();
+
+    /**
+    * @brief Writes every held span as a Chrome trace-event JSON object, oldest first per thread.
+    *
+    * Must run after the recording threads have finished (they may have exited).
+    */
+    static void writeJson(std::ostream& out);
+
+    /**
+    * @class ScopedSpan
+    * @brief Records the time from its construction to the end of its scope as one span.
+    */
+    class ScopedSpan 
+    {
+    public:
+        explicit ScopedSpan(const char* name) : m_name(name), m_start(enabled() ? now() : 0) {}
+
+        ~ScopedSpan() 
+        {
+            if (m_start != 0) 
+            {
+                record(m_name, m_start, now() - m_start);
+            }
+        }
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_start;   /* 0 when recording was off at construction */
+    };
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+#ifdef INTERSECTION_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceRecorder::ScopedSpan TRACE_CONCAT(trace_span_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) do { if (TraceRecorder::enabled()) TraceRecorder::nameThread(name); } while (0)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // TRACE_RECORDER_HPP
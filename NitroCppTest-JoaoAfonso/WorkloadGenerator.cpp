@@ -0,0 +1,308 @@
+#include "WorkloadGenerator.h"
+#include "OverlapCounter.h"
+
+#include <cmath>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace 
+{
+    const Workload kWorkloads[] = {Workload::Uniform, Workload::Clustered, Workload::Nested, Workload::Grid,
+                                   Workload::HeavyTailed, Workload::Duplicates, Workload::AllOverlap};
+    const char* const kNames[] = {"uniform", "clustered", "nested", "grid", "heavy-tailed", "duplicates", "all-overlap"};
+
+    /* Nested stacks hold this many rectangles */
+    const size_t kNestDepth = 8;
+
+    int clampCoordinate(double value) 
+    {
+        const double limit = std::numeric_limits<int>::max() / 4;
+        return static_cast<int>(std::max(-limit, std::min(limit, value)));
+    }
+
+    /* Appends integers in decimal without locale or stream overhead */
+    char* appendInt(char* cursor, int value) 
+    {
+        char digits[16];
+        int length = 0;
+        unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+        do 
+        {
+            digits[length++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0) 
+        {
+            *cursor++ = '-';
+        }
+        while (length > 0) 
+        {
+            *cursor++ = digits[--length];
+        }
+        return cursor;
+    }
+
+    char* appendText(char* cursor, const char* text) 
+    {
+        while (*text != '\0') 
+        {
+            *cursor++ = *text++;
+        }
+        return cursor;
+    }
+
+    /* Formats rectangles into a fixed buffer flushed in large blocks: multi-gigabyte scenes are I/O bound, not format bound */
+    class JsonBlockWriter 
+    {
+    public:
+        explicit JsonBlockWriter(std::ostream& out) : m_out(out), m_buffer(kBlock + kLongest), m_cursor(m_buffer.data()) 
+        {
+            m_cursor = appendText(m_cursor, "{\"rects\": [");
+        }
+
+        void add(int x, int y, int w, int h) 
+        {
+            m_cursor = appendText(m_cursor, m_count == 0 ? "\n  {\"x\": " : ",\n  {\"x\": ");
+            m_cursor = appendInt(m_cursor, x);
+            m_cursor = appendText(m_cursor, ", \"y\": ");
+            m_cursor = appendInt(m_cursor, y);
+            m_cursor = appendText(m_cursor, ", \"w\": ");
+            m_cursor = appendInt(m_cursor, w);
+            m_cursor = appendText(m_cursor, ", \"h\": ");
+            m_cursor = appendInt(m_cursor, h);
+            m_cursor = appendText(m_cursor, "}");
+            ++m_count;
+
+            if (static_cast<size_t>(m_cursor - m_buffer.data()) >= kBlock) 
+            {
+                flush();
+            }
+        }
+
+        void finish() 
+        {
+            m_cursor = appendText(m_cursor, "\n]}\n");
+            flush();
+        }
+
+    private:
+        static const size_t kBlock = 1 << 16;
+        static const size_t kLongest = 80;
+
+        void flush() 
+        {
+            m_out.write(m_buffer.data(), m_cursor - m_buffer.data());
+            m_cursor = m_buffer.data();
+        }
+
+        std::ostream& m_out;
+        std::vector<char> m_buffer;
+        char* m_cursor;
+        size_t m_count = 0;
+    };
+
+    /* Draws the rectangles of a scene in order and passes each to sink(x, y, w, h), so callers can stream them */
+    template <typename Sink>
+    void emitWorkload(const WorkloadParams& params, Sink&& sink) 
+    {
+        if (params.mean_size <= 0 || !(params.density > 0.0)) 
+        {
+            throw std::invalid_argument("Workload size and density must be positive.");
+        }
+
+        std::mt19937_64 rng(params.seed);
+        const int64_t canvas = WorkloadGenerator::canvasSize(params);
+        const int size = params.mean_size;
+        std::uniform_int_distribution<int64_t> position(0, canvas - 1);
+        std::uniform_int_distribution<int> side(std::max(1, size / 2), std::max(1, size + size / 2));
+
+        size_t emitted = 0;
+        auto add = [&sink, &emitted](double x, double y, double w, double h) {
+            sink(clampCoordinate(x), clampCoordinate(y), std::max(1, clampCoordinate(w)), std::max(1, clampCoordinate(h)));
+            ++emitted;
+        };
+
+        switch (params.kind) 
+        {
+            case Workload::Uniform:
+                while (emitted < params.count) 
+                {
+                    add(position(rng), position(rng), side(rng), side(rng));
+                }
+                break;
+
+            case Workload::Clustered: 
+            {
+                /* About one hot spot per hundred rectangles, each spread over a few rectangle sizes */
+                size_t clusters = std::max<size_t>(1, params.count / 100);
+                std::vector<std::pair<double, double>> centres;
+                for (size_t i = 0; i < clusters; ++i) 
+                {
+                    centres.emplace_back(position(rng), position(rng));
+                }
+                std::uniform_int_distribution<size_t> pick(0, clusters - 1);
+                std::normal_distribution<double> spread(0.0, 3.0 * size);
+                while (emitted < params.count) 
+                {
+                    const auto& centre = centres[pick(rng)];
+                    add(centre.first + spread(rng), centre.second + spread(rng), side(rng), side(rng));
+                }
+                break;
+            }
+
+            case Workload::Nested:
+                while (emitted < params.count) 
+                {
+                    /* Each doll shrinks by the same margin on every side, so it lies strictly inside the previous one */
+                    double x = position(rng);
+                    double y = position(rng);
+                    double outer = 4.0 * kNestDepth + side(rng);
+                    for (size_t level = 0; level < kNestDepth && emitted < params.count; ++level) 
+                    {
+                        add(x + 2.0 * level, y + 2.0 * level, outer - 4.0 * level, outer - 4.0 * level);
+                    }
+                }
+                break;
+
+            case Workload::Grid: 
+            {
+                std::uniform_int_distribution<int64_t> cell(0, std::max<int64_t>(0, canvas / size - 1));
+                std::uniform_int_distribution<int> span(1, 2);
+                while (emitted < params.count) 
+                {
+                    add(double(cell(rng)) * size, double(cell(rng)) * size, span(rng) * size, span(rng) * size);
+                }
+                break;
+            }
+
+            case Workload::HeavyTailed: 
+            {
+                /* Pareto with shape 1.5: finite mean, infinite variance; capped at the canvas */
+                std::uniform_real_distribution<double> unit(std::numeric_limits<double>::min(), 1.0);
+                auto pareto = [&]() { return std::min<double>(double(canvas), 0.5 * size * std::pow(unit(rng), -1.0 / 1.5)); };
+                while (emitted < params.count) 
+                {
+                    add(position(rng), position(rng), pareto(), pareto());
+                }
+                break;
+            }
+
+            case Workload::Duplicates: 
+            {
+                /* One distinct rectangle per ten, each repeated about ten times in random order */
+                size_t distinct = std::max<size_t>(1, params.count / 10);
+                std::vector<Rectangle> pool;
+                for (size_t i = 0; i < distinct; ++i) 
+                {
+                    pool.emplace_back(0, clampCoordinate(position(rng)), clampCoordinate(position(rng)), side(rng), side(rng));
+                }
+                std::uniform_int_distribution<size_t> pick(0, distinct - 1);
+                while (emitted < params.count) 
+                {
+                    const Rectangle& rect = pool[pick(rng)];
+                    add(rect.x(), rect.y(), rect.w(), rect.h());
+                }
+                break;
+            }
+
+            case Workload::AllOverlap: 
+            {
+                /* Every rectangle contains the centre point */
+                double centre = canvas / 2.0;
+                std::uniform_int_distribution<int> reach(1, std::max(1, size));
+                while (emitted < params.count) 
+                {
+                    double left = reach(rng), top = reach(rng);
+                    add(centre - left, centre - top, left + reach(rng), top + reach(rng));
+                }
+                break;
+            }
+        }
+    }
+}
+
+int64_t WorkloadGenerator::canvasSize(const WorkloadParams& params) 
+{
+    /* n rectangles of area s^2 on a C x C canvas cover a point density = n s^2 / C^2 times on average */
+    double side = params.mean_size * std::sqrt(std::max<size_t>(1, params.count) / params.density);
+    return std::max<int64_t>(params.mean_size, static_cast<int64_t>(std::ceil(side)));
+}
+
+double WorkloadGenerator::densityForPairs(const WorkloadParams& params, uint64_t target_pairs) 
+{
+    WorkloadParams sample = params;
+    sample.count = std::min<size_t>(params.count, WORKLOAD_CALIBRATION_SAMPLE);
+    const double scale = sample.count == 0 ? 0.0 : double(params.count) / sample.count;
+
+    /* Pairs grow with density, so bisect it on a logarithmic scale */
+    double low = 1e-6;
+    double high = 1e4;
+    for (int step = 0; step < 32; ++step) 
+    {
+        sample.density = std::sqrt(low * high);
+        double pairs = scale * OverlapCounter::countOverlappingPairs(generate(sample));
+        if (pairs < double(target_pairs)) 
+        {
+            low = sample.density;
+        }
+        else 
+        {
+            high = sample.density;
+        }
+    }
+    return std::sqrt(low * high);
+}
+
+std::vector<Rectangle> WorkloadGenerator::generate(const WorkloadParams& params) 
+{
+    std::vector<Rectangle> rectangles;
+    rectangles.reserve(params.count);
+    emitWorkload(params, [&rectangles](int x, int y, int w, int h) {
+        rectangles.emplace_back(static_cast<int>(rectangles.size() + 1), x, y, w, h);
+    });
+    return rectangles;
+}
+
+const char* WorkloadGenerator::name(Workload kind) 
+{
+    return kNames[static_cast<size_t>(kind)];
+}
+
+bool WorkloadGenerator::parse(const std::string& text, Workload& kind) 
+{
+    bool boReturn = false;
+    for (Workload candidate : kWorkloads) 
+    {
+        if (text == name(candidate)) 
+        {
+            kind = candidate;
+            boReturn = true;
+        }
+    }
+    return boReturn;
+}
+
+std::vector<Workload> WorkloadGenerator::all() 
+{
+    return std::vector<Workload>(std::begin(kWorkloads), std::end(kWorkloads));
+}
+
+void WorkloadGenerator::writeJson(std::ostream& out, const std::vector<Rectangle>& rectangles) 
+{
+    JsonBlockWriter writer(out);
+    for (const Rectangle& rect : rectangles) 
+    {
+        writer.add(rect.x(), rect.y(), rect.w(), rect.h());
+    }
+    writer.finish();
+}
+
+void WorkloadGenerator::streamJson(std::ostream& out, const WorkloadParams& params) 
+{
+    JsonBlockWriter writer(out);
+    emitWorkload(params, [&writer](int x, int y, int w, int h) { writer.add(x, y, w, h); });
+    writer.finish();
+}
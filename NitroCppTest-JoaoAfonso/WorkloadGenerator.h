@@ -0,0 +1,104 @@
+#ifndef WORKLOAD_GENERATOR_HPP
+#define WORKLOAD_GENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include "Rectangle.h"
+
+/* Largest scene generated to calibrate a density against a target pair count */
+#define WORKLOAD_CALIBRATION_SAMPLE 100000u
+
+/**
+* @brief Shapes of synthetic scenes.
+*/
+enum class Workload 
+{
+    Uniform,      /* Similar sizes, positions uniform over the canvas */
+    Clustered,    /* Positions drawn around a few hot spots */
+    Nested,       /* Russian dolls: stacks of rectangles each containing the next */
+    Grid,         /* Positions and sizes snapped to a coarse lattice, so edges coincide */
+    HeavyTailed,  /* Pareto-distributed sizes: mostly small, a few huge */
+    Duplicates,   /* Few distinct rectangles, each repeated many times */
+    AllOverlap    /* Every rectangle covers the canvas centre: 2^n - n - 1 intersections */
+};
+
+/**
+* @struct WorkloadParams
+* @brief Parameters of a synthetic scene.
+*/
+struct WorkloadParams 
+{
+    Workload kind = Workload::Uniform;
+    size_t count = 1000;      /* Number of rectangles */
+    uint64_t seed = 1;        /* Same seed and parameters give the same scene */
+    int mean_size = 100;      /* Typical side length */
+    double density = 1.0;     /* Mean number of rectangles covering a point of the canvas; sets the canvas size */
+};
+
+/**
+* @class WorkloadGenerator
+* @brief Generates reproducible synthetic scenes for benchmarks and load tests.
+*/
+class WorkloadGenerator 
+{
+public:
+    /**
+    * @brief Generates a scene.
+    * @param params Shape, size, seed and density.
+    * @return Rectangles with IDs 1..count and positive sizes.
+    * @throws std::invalid_argument if mean_size or density is not positive.
+    */
+    static std::vector<Rectangle> generate(const WorkloadParams& params);
+
+    /**
+    * @brief Returns the side length of the square canvas for a parameter set.
+    */
+    static int64_t canvasSize(const WorkloadParams& params);
+
+    /**
+    * @brief Finds the density at which a scene has about the given number of overlapping pairs.
+    *
+    * Counts the pairs of scenes of up to WORKLOAD_CALIBRATION_SAMPLE rectangles (same shape, size and seed) and scales
+    * them linearly to params.count, which holds as long as each rectangle meets a number of neighbours set by the
+    * density alone. Workloads whose overlaps do not depend on density (all-overlap) get the closest reachable value.
+    * @param params Shape, count, seed and size of the scene; the density is ignored.
+    * @param target_pairs Wanted number of overlapping pairs.
+    * @return Density to store in params.density.
+    */
+    static double densityForPairs(const WorkloadParams& params, uint64_t target_pairs);
+
+    /**
+    * @brief Returns the command-line name of a workload (e.g. "heavy-tailed").
+    */
+    static const char* name(Workload kind);
+
+    /**
+    * @brief Parses a workload name.
+    * @return false if the name is unknown.
+    */
+    static bool parse(const std::string& text, Workload& kind);
+
+    /**
+    * @brief Returns every workload, in declaration order.
+    */
+    static std::vector<Workload> all();
+
+    /**
+    * @brief Writes rectangles in the JSON schema read by Rectangle::loadFromFile.
+    * @param out Destination stream.
+    * @param rectangles Rectangles to write; IDs are implied by their order.
+    */
+    static void writeJson(std::ostream& out, const std::vector<Rectangle>& rectangles);
+
+    /**
+    * @brief Generates a scene straight into JSON without holding it in memory.
+    *
+    * Writes the same text as writeJson(out, generate(params)), so scenes larger than memory can be produced.
+    * @throws std::invalid_argument if mean_size or density is not positive.
+    */
+    static void streamJson(std::ostream& out, const WorkloadParams& params);
+};
+
+#endif // WORKLOAD_GENERATOR_HPP
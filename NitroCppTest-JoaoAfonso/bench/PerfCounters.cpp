@@ -0,0 +1,148 @@
+#include "PerfCounters.h"
+
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace 
+{
+    const char* const kEventNames[] = {"cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"};
+
+#ifdef __linux__
+    void describe(PerfEvent event, perf_event_attr& attr) 
+    {
+        const uint64_t read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        switch (event) 
+        {
+            case PerfEvent::Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfEvent::Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfEvent::L1dMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | read_miss;
+                break;
+            case PerfEvent::LlcMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_LL | read_miss;
+                break;
+            case PerfEvent::BranchMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        }
+    }
+#endif
+}
+
+PerfCounters::PerfCounters() 
+{
+    for (size_t i = 0; i < PerfSample::kEvents; ++i) 
+    {
+        m_fds[i] = -1;
+
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        describe(static_cast<PerfEvent>(i), attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;   /* User space only: allowed at the default perf_event_paranoid of 2 */
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (m_fds[i] < 0 && m_error.empty()) 
+        {
+            m_error = std::string(name(static_cast<PerfEvent>(i))) + ": " + std::strerror(errno);
+        }
+#else
+        m_error = "perf_event_open is only available on Linux";
+#endif
+    }
+}
+
+PerfCounters::~PerfCounters() 
+{
+#ifdef __linux__
+    for (int fd : m_fds) 
+    {
+        if (fd >= 0) 
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const 
+{
+    bool boReturn = false;
+    for (int fd : m_fds) 
+    {
+        if (fd >= 0) 
+        {
+            boReturn = true;
+        }
+    }
+    return boReturn;
+}
+
+void PerfCounters::start() 
+{
+#ifdef __linux__
+    for (int fd : m_fds) 
+    {
+        if (fd >= 0) 
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfSample PerfCounters::stop() 
+{
+    PerfSample sample;
+
+#ifdef __linux__
+    for (int fd : m_fds) 
+    {
+        if (fd >= 0) 
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i < PerfSample::kEvents; ++i) 
+    {
+        /* value, time enabled, time running */
+        uint64_t data[3] = {};
+        if (m_fds[i] >= 0 && read(m_fds[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[2] > 0) 
+        {
+            /* Scale up when the kernel multiplexed the counter for part of the run */
+            sample.values[i] = data[2] < data[1] ? static_cast<uint64_t>(double(data[0]) * data[1] / data[2]) : data[0];
+            sample.valid[i] = true;
+        }
+    }
+#endif
+
+    return sample;
+}
+
+const char* PerfCounters::name(PerfEvent event) 
+{
+    return kEventNames[static_cast<size_t>(event)];
+}
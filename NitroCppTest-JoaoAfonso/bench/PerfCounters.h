@@ -0,0 +1,84 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+* @brief Hardware events counted around each benchmarked engine.
+*/
+enum class PerfEvent 
+{
+    Cycles,         /* CPU cycles */
+    Instructions,   /* Retired instructions */
+    L1dMisses,      /* L1 data cache read misses */
+    LlcMisses,      /* Last-level cache read misses */
+    BranchMisses    /* Mispredicted branches */
+};
+
+/**
+* @struct PerfSample
+* @brief Event counts of one measured run; events the machine could not count are marked invalid.
+*/
+struct PerfSample 
+{
+    static const size_t kEvents = static_cast<size_t>(PerfEvent::BranchMisses) + 1;
+
+    uint64_t values[kEvents] = {};
+    bool valid[kEvents] = {};
+};
+
+/**
+* @class PerfCounters
+* @brief Counts hardware events of the calling thread in user space through perf_event_open.
+*
+* Each event is opened on its own, so a machine without, say, last-level cache events still reports
+* the others. Where perf_event_open is missing or forbidden (non-Linux systems, containers, or
+* kernel.perf_event_paranoid above 2) no event opens and every sample comes back invalid.
+* Counts are scaled up when the kernel multiplexed the counters.
+*/
+class PerfCounters 
+{
+private:
+    int m_fds[PerfSample::kEvents];
+    std::string m_error;     /* Why the first unavailable event could not be opened */
+
+public:
+    /**
+    * @brief Opens every event that the machine and its permissions allow.
+    */
+    PerfCounters();
+
+    /**
+    * @brief Closes the events.
+    */
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+    * @brief Returns true if at least one event could be opened.
+    */
+    bool available() const;
+
+    inline const std::string& error() const { return m_error; }  /* Returns why an event could not be opened, or "". */
+
+    /**
+    * @brief Resets and starts every open event.
+    */
+    void start();
+
+    /**
+    * @brief Stops the events and returns their counts since start().
+    */
+    PerfSample stop();
+
+    /**
+    * @brief Returns the report name of an event (e.g. "llc-misses").
+    */
+    static const char* name(PerfEvent event);
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,370 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <functional>
+#include <memory>
+#include "IntersectionFinder.h"
+#include "OrderCounter.h"
+#include "WorkloadGenerator.h"
+#include "RunStats.h"
+#include "ThreadPool.h"
+#include "PerfCounters.h"
+
+/* Largest scenes each engine is run on; beyond these the engine is quadratic or memory bound */
+#define BENCH_MAX_JSON_SIZE 1000000u        /* JSON text is kept in memory */
+#define BENCH_MAX_ENUMERATE_SIZE 5000u      /* processIntersections tests every pair */
+#define BENCH_MAX_MAXIMAL_SIZE 20000u       /* processMaximalIntersections builds the overlap graph pairwise */
+#define BENCH_MAX_CELLS_SIZE 2000u          /* processArrangementCells produces O(n^2) cells */
+#define BENCH_MAX_ORDERS_SIZE 20000u        /* countIntersectionsByOrder grows quadratically on realistic scenes */
+#define BENCH_MAX_PAIRS 5000000u            /* count-orders (arbitrary precision) and maximal (adjacency lists) work per overlapping pair */
+
+/* Queries timed per scene for the index */
+#define BENCH_QUERIES 10000u
+
+namespace 
+{
+    struct BenchOptions 
+    {
+        std::vector<Workload> workloads = WorkloadGenerator::all();
+        size_t min_size = 10;
+        size_t max_size = 10000000;
+        uint64_t seed = 1;
+        uint64_t max_results = 100000;    /* Enumerating engines are skipped when more results are predicted */
+        bool csv = false;
+        PerfCounters* perf = nullptr;     /* Hardware counters read around each engine (--perf) */
+        ThreadPool* pool = nullptr;       /* Searches the overlap components of enumerate-mt */
+    };
+
+    struct Measurement 
+    {
+        double seconds = 0;
+        uint64_t allocations = 0;     /* Heap allocations of the measured call (INTERSECTION_STATS builds) */
+        PerfSample perf;
+        bool calling_thread = true;   /* False when the work ran on pool threads, which the per-thread allocation and perf counters miss */
+    };
+
+    /* Discards everything written to it, so printing is timed without terminal I/O */
+    class NullBuffer : public std::streambuf 
+    {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    Measurement measure(const BenchOptions& options, const std::function<void()>& run) 
+    {
+        Measurement measured;
+        if (options.perf != nullptr) 
+        {
+            options.perf->start();
+        }
+        uint64_t allocations = RunStats::threadAllocations();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        measured.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        measured.allocations = RunStats::threadAllocations() - allocations;
+        if (options.perf != nullptr) 
+        {
+            measured.perf = options.perf->stop();
+        }
+        return measured;
+    }
+
+    /* Formats an event count per unit, or "n/a" (empty in CSV) when the event was not counted */
+    std::string perUnit(const PerfSample& sample, size_t event, uint64_t units, bool csv) 
+    {
+        char text[32] = "";
+        if (sample.valid[event] && units > 0) 
+        {
+            std::snprintf(text, sizeof(text), csv ? "%.4g" : "%.3g", double(sample.values[event]) / units);
+        }
+        else if (!csv) 
+        {
+            std::snprintf(text, sizeof(text), "n/a");
+        }
+        return text;
+    }
+
+    void report(const BenchOptions& options, Workload kind, size_t count, const char* engine, const Measurement& measured, uint64_t results) 
+    {
+        const double seconds = measured.seconds;
+        double rate = seconds > 0 ? count / seconds : 0;
+        double result_rate = seconds > 0 ? results / seconds : 0;
+        double allocation_rate = results > 0 ? double(measured.allocations) / results : 0;
+
+        /* Counters that only saw the calling thread are reported as not counted rather than as near zero */
+        const bool allocations_counted = RunStats::compiledIn() && measured.calling_thread;
+        const PerfSample perf = measured.calling_thread ? measured.perf : PerfSample();
+
+        if (options.csv) 
+        {
+            std::printf("%s,%zu,%s,%.6f,%.0f,%llu,%.0f,", WorkloadGenerator::name(kind), count, engine, seconds, rate,
+                        static_cast<unsigned long long>(results), result_rate);
+            if (allocations_counted) 
+            {
+                std::printf("%.4g", allocation_rate);
+            }
+            for (size_t event = 0; options.perf != nullptr && event < PerfSample::kEvents; ++event) 
+            {
+                std::printf(",%s,%s", perUnit(perf, event, count, true).c_str(), perUnit(perf, event, results, true).c_str());
+            }
+            std::printf("\n");
+        }
+        else 
+        {
+            std::printf("%-13s %9zu  %-14s %10.6f s %14.0f rect/s %12llu results %14.0f results/s", WorkloadGenerator::name(kind),
+                        count, engine, seconds, rate, static_cast<unsigned long long>(results), result_rate);
+            if (allocations_counted) 
+            {
+                std::printf(" %10.3f allocs/result", allocation_rate);
+            }
+            else if (RunStats::compiledIn()) 
+            {
+                std::printf(" %10s allocs/result", "n/a");
+            }
+            std::printf("\n");
+            if (options.perf != nullptr) 
+            {
+                /* Each event per rectangle and per result, under the row it belongs to */
+                std::printf("%13s", "");
+                for (size_t event = 0; event < PerfSample::kEvents; ++event) 
+                {
+                    std::printf("  %s %s/rect %s/result", PerfCounters::name(static_cast<PerfEvent>(event)),
+                                perUnit(perf, event, count, false).c_str(), perUnit(perf, event, results, false).c_str());
+                }
+                std::printf("\n");
+            }
+        }
+        std::fflush(stdout);
+    }
+
+    void benchScene(const BenchOptions& options, Workload kind, size_t count) 
+    {
+        WorkloadParams params;
+        params.kind = kind;
+        params.count = count;
+        params.seed = options.seed;
+        const std::vector<Rectangle> rectangles = WorkloadGenerator::generate(params);
+
+        Measurement measured;
+        NullBuffer null_buffer;
+        std::ostream null_stream(&null_buffer);
+        IntersectionFinder finder;
+
+        if (count <= BENCH_MAX_JSON_SIZE) 
+        {
+            std::ostringstream json;
+            WorkloadGenerator::writeJson(json, rectangles);
+            std::istringstream input(json.str());
+            measured = measure(options, [&]() { finder.loadRectanglesFromStream(input, 0, null_stream); });
+            report(options, kind, count, "load-json", measured, count);
+        }
+        else 
+        {
+            finder.loadRectangles(std::vector<Rectangle>(rectangles));
+        }
+
+        uint64_t pairs = 0;
+        measured = measure(options, [&]() { pairs = finder.countOverlappingPairs(); });
+        report(options, kind, count, "count-pairs", measured, pairs);
+
+        /* Enumeration is only attempted when the exact count is known to be small */
+        bool enumerable = false;
+        if (count <= BENCH_MAX_ORDERS_SIZE && pairs <= BENCH_MAX_PAIRS) 
+        {
+            std::vector<BigUnsigned> orders;
+            measured = measure(options, [&]() { orders = finder.countIntersectionsByOrder(); });
+            BigUnsigned total = OrderCounter::totalIntersections(orders);
+            uint64_t predicted = 0;
+            enumerable = total.toUint64(predicted) && predicted <= options.max_results;
+            report(options, kind, count, "count-orders", measured, enumerable ? predicted : 0);
+        }
+
+        size_t depth = 0;
+        measured = measure(options, [&]() { depth = finder.findMaxDepth().parent_ids.size(); });
+        report(options, kind, count, "max-depth", measured, depth);
+
+        AreaStats stats;
+        measured = measure(options, [&]() { stats = finder.computeAreaStats(); });
+        report(options, kind, count, "area", measured, stats.area_by_depth.size());
+
+        measured = measure(options, [&]() { finder.buildIndex(); });
+        report(options, kind, count, "index-build", measured, count);
+
+        /* Windows of about one rectangle, placed uniformly over the canvas */
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<int64_t> position(0, WorkloadGenerator::canvasSize(params));
+        std::vector<Rectangle> windows;
+        for (size_t i = 0; i < BENCH_QUERIES; ++i) 
+        {
+            windows.emplace_back(-1, static_cast<int>(position(rng)), static_cast<int>(position(rng)), params.mean_size, params.mean_size);
+        }
+        uint64_t hits = 0;
+        measured = measure(options, [&]() {
+            for (const auto& window : windows) 
+            {
+                hits += finder.queryWindow(window).size();
+            }
+        });
+        report(options, kind, count, "window-query", measured, hits);
+
+        if (enumerable && count <= BENCH_MAX_ENUMERATE_SIZE) 
+        {
+            finder.loadRectangles(std::vector<Rectangle>(rectangles));
+            measured = measure(options, [&]() { finder.processIntersections(); });
+            report(options, kind, count, "enumerate", measured, finder.intersections().size());
+            measured = measure(options, [&]() { finder.processIntersections(options.pool); });
+            measured.calling_thread = false;
+            report(options, kind, count, "enumerate-mt", measured, finder.intersections().size());
+            measured = measure(options, [&]() { finder.printResults(null_stream); });
+            report(options, kind, count, "print", measured, finder.intersections().size());
+
+            IntersectionFinder incremental;
+            incremental.loadRectangles({rectangles[0], rectangles[1]});
+            incremental.processIntersections();
+            std::vector<IntersectionResult> new_groups;
+            measured = measure(options, [&]() {
+                for (size_t i = 2; i < rectangles.size(); ++i) 
+                {
+                    incremental.insert(rectangles[i], new_groups);
+                }
+            });
+            report(options, kind, count, "insert", measured, incremental.intersections().size());
+        }
+
+        if (count <= BENCH_MAX_MAXIMAL_SIZE && pairs <= BENCH_MAX_PAIRS) 
+        {
+            finder.loadRectangles(std::vector<Rectangle>(rectangles));
+            measured = measure(options, [&]() { finder.processMaximalIntersections(); });
+            report(options, kind, count, "maximal", measured, finder.intersections().size());
+        }
+
+        if (count <= BENCH_MAX_CELLS_SIZE) 
+        {
+            finder.loadRectangles(std::vector<Rectangle>(rectangles));
+            measured = measure(options, [&]() { finder.processArrangementCells(); });
+            report(options, kind, count, "cells", measured, finder.intersections().size());
+        }
+    }
+}
+
+/**
+ * @brief Entry point of the benchmark suite.
+ *
+ * Generates each workload at sizes 10, 100, ... up to --max-size and times every engine on it,
+ * reporting seconds, rectangles per second, results per second and, in INTERSECTION_STATS builds,
+ * heap allocations per result. Options:
+ * - --workload <name>: run only this workload (repeatable); names as in WorkloadGenerator::name().
+ * - --min-size <n> / --max-size <n>: range of scene sizes (default 10 to 10^7).
+ * - --seed <n>: generator seed (default 1).
+ * - --max-results <n>: skip enumerating engines when more results are predicted (default 10^5).
+ * - --csv: print comma-separated values instead of a table.
+ * - --perf: also count cycles, instructions, cache and branch misses per rectangle and per result
+ *   (Linux perf_event_open; events the machine does not allow are reported as n/a).
+ */
+int main(int argc, char* argv[]) 
+{
+    BenchOptions options;
+    bool custom_workloads = false;
+    std::unique_ptr<PerfCounters> perf;
+    ThreadPool pool;
+    options.pool = &pool;
+
+    try 
+    {
+        for (int i = 1; i < argc; ++i) 
+        {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+
+            if (arg == "--workload" && has_value) 
+            {
+                Workload kind;
+                if (!WorkloadGenerator::parse(argv[++i], kind)) 
+                {
+                    throw std::invalid_argument(std::string("Unknown workload: ") + argv[i]);
+                }
+                if (!custom_workloads) 
+                {
+                    options.workloads.clear();
+                    custom_workloads = true;
+                }
+                options.workloads.push_back(kind);
+            }
+            else if (arg == "--min-size" && has_value) 
+            {
+                options.min_size = std::stoull(argv[++i]);
+            }
+            else if (arg == "--max-size" && has_value) 
+            {
+                options.max_size = std::stoull(argv[++i]);
+            }
+            else if (arg == "--seed" && has_value) 
+            {
+                options.seed = std::stoull(argv[++i]);
+            }
+            else if (arg == "--max-results" && has_value) 
+            {
+                options.max_results = std::stoull(argv[++i]);
+            }
+            else if (arg == "--csv") 
+            {
+                options.csv = true;
+            }
+            else if (arg == "--perf") 
+            {
+                perf.reset(new PerfCounters);
+                if (!perf->available()) 
+                {
+                    std::cerr << "Warning: hardware counters unavailable (" << perf->error() << "), timing only\n";
+                    continue;
+                }
+                if (!perf->error().empty()) 
+                {
+                    std::cerr << "Warning: some hardware counters unavailable (" << perf->error() << ")\n";
+                }
+                options.perf = perf.get();
+            }
+            else 
+            {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+
+        if (options.csv) 
+        {
+            std::printf("workload,rectangles,engine,seconds,rectangles_per_second,results,results_per_second,allocations_per_result");
+            for (size_t event = 0; options.perf != nullptr && event < PerfSample::kEvents; ++event) 
+            {
+                const char* name = PerfCounters::name(static_cast<PerfEvent>(event));
+                std::printf(",%s_per_rectangle,%s_per_result", name, name);
+            }
+            std::printf("\n");
+        }
+
+        for (Workload kind : options.workloads) 
+        {
+            for (size_t count = 10; count <= options.max_size; count *= 10) 
+            {
+                if (count >= options.min_size) 
+                {
+                    benchScene(options, kind, count);
+                }
+            }
+        }
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        std::cerr << "Usage: " << argv[0] << " [--workload <name>]... [--min-size <n>] [--max-size <n>] [--seed <n>]"
+                  << " [--max-results <n>] [--csv] [--perf]\n";
+        return 1;
+    }
+
+    return 0;
+}
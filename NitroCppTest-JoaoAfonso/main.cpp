@@ -1,43 +1,274 @@
-#include <iostream>
-#include "IntersectionFinder.h"
-
-/**
- * @brief Entry point of the application.
- *
- * Expects a single command-line argument specifying the JSON input file.
- * Loads rectangles, computes all intersections, and prints the results.
- */
-int main(int argc, char* argv[]) 
-{
-    if (argc != 2) 
-    {
-        std::cerr << "Usage: " << argv[0] << " <json_file>\n";
-        return 1;
-    }
-
-    try 
-    {
-        IntersectionFinder finder;
-        finder.loadRectanglesFromFile(argv[1]);
-        finder.processIntersections();
-        finder.printResults();
-    } 
-    
-    catch (const std::runtime_error& e) 
-    {
-        std::cerr << "Runtime error: " << e.what() << "\n";
-        return 1;
-    } 
-    catch (const std::exception& e) 
-    {
-        std::cerr << "Unexpected error: " << e.what() << "\n";
-        return 1;
-    } 
-    catch (...) 
-    {
-        std::cerr << "An unknown error occurred.\n";
-        return 1;
-    }
-
-    return 0; 
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <memory>
+#include "IntersectionFinder.h"
+#include "SceneServer.h"
+#include "BatchRunner.h"
+#include "PipelineRunner.h"
+#include "IndexSnapshot.h"
+#include "RunStats.h"
+#include "TraceRecorder.h"
+
+namespace 
+{
+    /* Writes the --stats and --trace reports when main returns, whichever path it returns by */
+    class ExitReports 
+    {
+    public:
+        ExitReports(const std::string& stats_path, const std::string& trace_path) : m_statsPath(stats_path), m_tracePath(trace_path) 
+        {
+            RunStats::enable(!m_statsPath.empty());
+            TraceRecorder::enable(!m_tracePath.empty());
+            TRACE_THREAD_NAME("main");
+        }
+
+        ~ExitReports() 
+        {
+            if (!m_statsPath.empty()) 
+            {
+                RunStats::enable(false);
+                write(m_statsPath, "statistics", RunStats::writeJson);
+            }
+            if (!m_tracePath.empty()) 
+            {
+                TraceRecorder::enable(false);
+                write(m_tracePath, "trace", TraceRecorder::writeJson);
+            }
+        }
+
+    private:
+        std::string m_statsPath;
+        std::string m_tracePath;
+
+        /* "-" is stderr */
+        static void write(const std::string& path, const char* what, void (*report)(std::ostream&)) 
+        {
+            if (path == "-") 
+            {
+                report(std::cerr);
+                return;
+            }
+
+            std::ofstream file(path);
+            report(file);
+            if (!file) 
+            {
+                std::cerr << "Could not write " << what << " to " << path << "\n";
+            }
+        }
+    };
+}
+
+/**
+ * @brief Entry point of the application.
+ *
+ * Expects the JSON input file as the last command-line argument, optionally preceded by:
+ * - --maximal: report only the inclusion-maximal overlapping groups.
+ * - --cells: report the disjoint arrangement cells, each with its coverage set.
+ * - --count-pairs: print only the number of overlapping pairs (no rectangle limit).
+ * - --count-orders: print the number of intersecting groups of each size (no rectangle limit).
+ * - --max-depth: print the largest number of rectangles covering one point, with a witness (no rectangle limit).
+ * - --area: print the union area and the area covered by exactly k rectangles (no rectangle limit).
+ * - --max-results <n>: refuse to enumerate when more than n intersections are predicted.
+ * - --write-index <snapshot>: build the spatial index of the JSON file and save it as an mmap-able snapshot,
+ *   which --serve loads without parsing or rebuilding.
+ * - --serve <socket_path>: run as a scene server on a Unix domain socket instead (no JSON file).
+ * - --batch <source>: process every scene of a directory, list file or NDJSON file ("-" reads NDJSON
+ *   from stdin) on a thread pool, printing the outputs in input order (no JSON file).
+ * - --threads <n>: worker threads for --batch (default: hardware concurrency).
+ * - --cache <dir>: reuse enumeration results of scenes already seen, stored under dir.
+ * - --pipeline: run --batch as overlapping load / compute / output stages connected by bounded queues.
+ * - --stats / --stats-file <file>: at exit, write per-phase times and engine counters as JSON to stderr or a file
+ *   (needs a build with INTERSECTION_STATS).
+ * - --trace <file>: at exit, write the timeline of every thread as Chrome trace-event JSON, for Perfetto
+ *   (needs a build with INTERSECTION_TRACE).
+ * Loads rectangles, computes the intersections, and prints the results.
+ */
+int main(int argc, char* argv[]) 
+{
+    std::string mode;
+    std::string filename;
+    std::string max_results;
+    std::string socket_path;
+    std::string batch_source;
+    std::string threads;
+    bool pipeline = false;
+    std::string cache_directory;
+    std::string snapshot_path;
+    std::string stats_path;
+    std::string trace_path;
+
+    for (int i = 1; i < argc; ++i) 
+    {
+        std::string arg = argv[i];
+
+        if (mode.empty() && (arg == "--maximal" || arg == "--cells" || arg == "--count-pairs" || arg == "--count-orders" ||
+                               arg == "--max-depth" || arg == "--area")) 
+        {
+            mode = arg;
+        }
+        else if (arg == "--max-results" && i + 1 < argc) 
+        {
+            max_results = argv[++i];
+        }
+        else if (arg == "--serve" && i + 1 < argc) 
+        {
+            socket_path = argv[++i];
+        }
+        else if (arg == "--batch" && i + 1 < argc) 
+        {
+            batch_source = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) 
+        {
+            threads = argv[++i];
+        }
+        else if (arg == "--cache" && i + 1 < argc) 
+        {
+            cache_directory = argv[++i];
+        }
+        else if (arg == "--write-index" && i + 1 < argc) 
+        {
+            snapshot_path = argv[++i];
+        }
+        else if (arg == "--pipeline") 
+        {
+            pipeline = true;
+        }
+        else if (arg == "--stats") 
+        {
+            stats_path = "-";
+        }
+        else if (arg == "--stats-file" && i + 1 < argc) 
+        {
+            stats_path = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) 
+        {
+            trace_path = argv[++i];
+        }
+        else if (filename.empty() && arg.rfind("--", 0) != 0) 
+        {
+            filename = arg;
+        }
+        else 
+        {
+            filename.clear();
+            socket_path.clear();
+            batch_source.clear();
+            break;
+        }
+    }
+
+    int sources = !filename.empty() + !socket_path.empty() + !batch_source.empty();
+    if (sources != 1 || (pipeline && batch_source.empty()) || (!snapshot_path.empty() && filename.empty())) 
+    {
+        std::cerr << "Usage: " << argv[0] << " [--maximal | --cells | --count-pairs | --count-orders | --max-depth | --area]"
+                  << " [--max-results <n>] [--cache <dir>] [--stats | --stats-file <file>] [--trace <file>] <json_file>\n"
+                  << "       " << argv[0] << " [mode] [--max-results <n>] --batch <dir | list | file.ndjson | -> [--threads <n>] [--pipeline] [--cache <dir>]\n"
+                  << "       " << argv[0] << " --write-index <snapshot> <json_file>\n"
+                  << "       " << argv[0] << " --serve <socket_path>\n";
+        return 1;
+    }
+
+    if (!stats_path.empty() && !RunStats::compiledIn()) 
+    {
+        std::cerr << "Statistics are not available: configure with -DINTERSECTION_STATS=ON.\n";
+        return 1;
+    }
+
+    if (!trace_path.empty() && !TraceRecorder::compiledIn()) 
+    {
+        std::cerr << "Tracing is not available: configure with -DINTERSECTION_TRACE=ON.\n";
+        return 1;
+    }
+
+    ExitReports exit_reports(stats_path, trace_path);
+
+    try 
+    {
+        if (!socket_path.empty()) 
+        {
+            SceneServer server(socket_path);
+            std::cout << "Serving on " << socket_path << "\n";
+            server.run();
+            return 0;
+        }
+
+        if (!snapshot_path.empty()) 
+        {
+            std::vector<Rectangle> rectangles = Rectangle::loadFromFile(filename, 0);
+            IndexSnapshot::write(snapshot_path, rectangles);
+            std::cout << "Wrote index of " << rectangles.size() << " rectangles to " << snapshot_path << "\n";
+            return 0;
+        }
+
+        BatchOptions options;
+        options.mode = mode;
+        if (!max_results.empty()) 
+        {
+            options.limit_results = true;
+            options.max_results = std::stoull(max_results);
+        }
+
+        std::unique_ptr<ResultCache> cache;
+        if (!cache_directory.empty()) 
+        {
+            cache.reset(new ResultCache(cache_directory));
+            options.cache = cache.get();
+        }
+
+        if (!batch_source.empty()) 
+        {
+            std::vector<BatchScene> scenes = batch_source == "-" ? BatchRunner::readNdjson(std::cin)
+                                                                 : BatchRunner::listScenes(batch_source);
+            size_t workers = threads.empty() ? 0 : std::stoul(threads);
+            size_t failed = 0;
+
+            if (pipeline) 
+            {
+                failed = PipelineRunner::run(scenes, options, workers, std::cout);
+            }
+            else 
+            {
+                ThreadPool pool(workers);
+                failed = BatchRunner::run(scenes, options, pool, std::cout);
+            }
+            if (failed != 0) 
+            {
+                std::cerr << failed << " of " << scenes.size() << " scenes failed.\n";
+                return 1;
+            }
+            return 0;
+        }
+
+        std::ifstream file(filename);
+        if (!file.is_open()) 
+        {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        IntersectionFinder finder;
+        BatchRunner::runScene(finder, options, file, std::cout);
+    } 
+    
+    catch (const std::runtime_error& e) 
+    {
+        std::cerr << "Runtime error: " << e.what() << "\n";
+        return 1;
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << "Unexpected error: " << e.what() << "\n";
+        return 1;
+    } 
+    catch (...) 
+    {
+        std::cerr << "An unknown error occurred.\n";
+        return 1;
+    }
+
+    return 0; 
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "../AreaCalculator.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+
+namespace {
+    // Per-depth area by counting the rectangles over every unit square
+    std::vector<int64_t> bruteForceAreaByDepth(const std::vector<Rectangle>& rects, int extent) {
+        std::vector<int64_t> area(rects.size() + 1, 0);
+        for (int x = 0; x < extent; ++x) {
+            for (int y = 0; y < extent; ++y) {
+                size_t depth = 0;
+                for (const auto& r : rects) {
+                    if (r.x() <= x && x < r.right() && r.y() <= y && y < r.bottom()) {
+                        ++depth;
+                    }
+                }
+                ++area[depth];
+            }
+        }
+        area[0] = 0;
+        while (!area.empty() && area.back() == 0) {
+            area.pop_back();
+        }
+        return area;
+    }
+}
+
+TEST_CASE("AreaCalculator::EmptyInput", "[AreaCalculator]") {
+    auto stats = AreaCalculator::computeAreaStats({});
+    REQUIRE(stats.union_area == 0);
+    REQUIRE(stats.area_by_depth.empty());
+}
+
+TEST_CASE("AreaCalculator::TwoOverlappingSquares", "[AreaCalculator]") {
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10)};
+    auto stats = AreaCalculator::computeAreaStats(rects);
+    REQUIRE(stats.union_area == 175);
+    REQUIRE(stats.area_by_depth == std::vector<int64_t>({0, 150, 25}));
+}
+
+TEST_CASE("AreaCalculator::LargeCoordinatesUse64BitArithmetic", "[AreaCalculator]") {
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 2000000000, 2000000000)};
+    auto stats = AreaCalculator::computeAreaStats(rects);
+    REQUIRE(stats.union_area == 4000000000000000000LL);
+}
+
+TEST_CASE("AreaCalculator::MatchesUnitSquareCountOnRandomScenes", "[AreaCalculator]") {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> position(0, 40);
+    std::uniform_int_distribution<int> size(1, 20);
+
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int id = 1; id <= 30; ++id) {
+            rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        }
+        auto expected = bruteForceAreaByDepth(rects, 60);
+        auto stats = AreaCalculator::computeAreaStats(rects);
+        REQUIRE(stats.area_by_depth == expected);
+
+        int64_t union_area = 0;
+        for (size_t k = 1; k < expected.size(); ++k) {
+            union_area += expected[k];
+        }
+        REQUIRE(stats.union_area == union_area);
+    }
+}
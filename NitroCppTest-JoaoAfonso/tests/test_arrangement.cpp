@@ -0,0 +1,94 @@
+#include "../ArrangementEngine.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <algorithm>
+
+namespace {
+    // IDs of the rectangles containing the centre of a cell (coordinates doubled to stay integral)
+    std::pmr::vector<int> coveringIds(const std::vector<Rectangle>& rects, const Rectangle& cell) {
+        long long cx = 2LL * cell.x() + cell.w();
+        long long cy = 2LL * cell.y() + cell.h();
+        std::pmr::vector<int> ids;
+        for (const auto& r : rects) {
+            if (2LL * r.x() < cx && cx < 2LL * r.right() && 2LL * r.y() < cy && cy < 2LL * r.bottom()) {
+                ids.push_back(r.id());
+            }
+        }
+        return ids;
+    }
+}
+
+TEST_CASE("ArrangementEngine::SingleRectangleIsOneCell", "[ArrangementEngine]") {
+    std::vector<Rectangle> rects = {Rectangle(1, 3, 4, 10, 20)};
+    auto cells = ArrangementEngine::buildCells(rects);
+    REQUIRE(cells.size() == 1);
+    CHECK(cells[0].rect.x() == 3);
+    CHECK(cells[0].rect.y() == 4);
+    CHECK(cells[0].rect.w() == 10);
+    CHECK(cells[0].rect.h() == 20);
+    CHECK(cells[0].parent_ids == std::pmr::vector<int>({1}));
+}
+
+TEST_CASE("ArrangementEngine::IdenticalRectanglesShareOneCell", "[ArrangementEngine]") {
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 6; ++id) {
+        rects.emplace_back(id, 0, 0, 5, 5);
+    }
+    auto cells = ArrangementEngine::buildCells(rects);
+    REQUIRE(cells.size() == 1);
+    CHECK(cells[0].parent_ids == std::pmr::vector<int>({1, 2, 3, 4, 5, 6}));
+}
+
+TEST_CASE("ArrangementEngine::CellsAreDisjointAndLabelledByCoverage", "[ArrangementEngine]") {
+    std::vector<Rectangle> rects = {
+        Rectangle(1, 100, 100, 250, 80),
+        Rectangle(2, 120, 200, 250, 150),
+        Rectangle(3, 140, 160, 250, 100),
+        Rectangle(4, 160, 140, 350, 190),
+        Rectangle(5, -50, -50, 60, 60),
+        Rectangle(6, 0, 0, 10, 500)
+    };
+    auto cells = ArrangementEngine::buildCells(rects);
+
+    // Bounded by the compressed grid
+    REQUIRE(cells.size() <= (2 * rects.size() - 1) * (2 * rects.size() - 1));
+
+    long long cell_area = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const auto& cell = cells[i];
+        REQUIRE(cell.parent_ids == coveringIds(rects, cell.rect));
+        cell_area += 1LL * cell.rect.w() * cell.rect.h();
+
+        for (size_t j = i + 1; j < cells.size(); ++j) {
+            Rectangle overlap(-1, 0, 0, 0, 0);
+            REQUIRE_FALSE(Rectangle::calculate_intersection(cell.rect, cells[j].rect, overlap));
+        }
+    }
+
+    // Cells tile the union exactly: count covered unit squares directly
+    long long union_area = 0;
+    for (int x = -50; x < 510; ++x) {
+        for (int y = -50; y < 500; ++y) {
+            for (const auto& r : rects) {
+                if (r.x() <= x && x < r.right() && r.y() <= y && y < r.bottom()) {
+                    ++union_area;
+                    break;
+                }
+            }
+        }
+    }
+    REQUIRE(cell_area == union_area);
+}
+
+TEST_CASE("ArrangementEngine::CoverageIsSortedWhenIdsDescend", "[ArrangementEngine]") {
+    /* IDs not ascending with input order, as loadRectangles() allows */
+    std::vector<Rectangle> rects = {Rectangle(9, 0, 0, 10, 10), Rectangle(4, 5, 5, 10, 10), Rectangle(7, 2, 2, 10, 10)};
+    auto cells = ArrangementEngine::buildCells(rects);
+    bool found_triple = false;
+    for (const auto& cell : cells) {
+        REQUIRE(std::is_sorted(cell.parent_ids.begin(), cell.parent_ids.end()));
+        found_triple = found_triple || cell.parent_ids == std::pmr::vector<int>({4, 7, 9});
+    }
+    REQUIRE(found_triple);
+}
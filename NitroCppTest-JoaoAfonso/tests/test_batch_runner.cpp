@@ -0,0 +1,136 @@
+#include "../BatchRunner.h"
+#include "../ThreadPool.h"
+#include "../IntersectionFinder.h"
+#include "test_helpers.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    std::string sceneJson(int offset) {
+        return "{\"rects\": [{\"x\": 0, \"y\": 0, \"w\": 10, \"h\": 10}, "
+               "{\"x\": " + std::to_string(offset) + ", \"y\": 0, \"w\": 10, \"h\": 10}, "
+               "{\"x\": 5, \"y\": 5, \"w\": 10, \"h\": 10}]}";
+    }
+}
+
+TEST_CASE("ThreadPool::RunsEveryIndexOnce", "[ThreadPool]") {
+    ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    for (int round = 0; round < 3; ++round) {
+        std::vector<std::atomic<int>> hits(1000);
+        std::atomic<size_t> bad_workers{0};
+        pool.parallelFor(hits.size(), [&](size_t index, size_t worker) {
+            /* Catch2 assertions are not thread safe, so check on the calling thread */
+            bad_workers += worker >= pool.size();
+            ++hits[index];
+        });
+        REQUIRE(bad_workers == 0);
+        for (const auto& hit : hits) {
+            REQUIRE(hit == 1);
+        }
+    }
+
+    std::atomic<int> calls{0};
+    pool.parallelFor(0, [&](size_t, size_t) { ++calls; });
+    REQUIRE(calls == 0);
+}
+
+TEST_CASE("ThreadPool::RethrowsTaskException", "[ThreadPool]") {
+    ThreadPool pool(3);
+    std::atomic<int> processed{0};
+    REQUIRE_THROWS_AS(pool.parallelFor(50, [&](size_t index, size_t) {
+        ++processed;
+        if (index == 7) {
+            throw std::runtime_error("boom");
+        }
+    }), std::runtime_error);
+    REQUIRE(processed == 50);
+
+    /* The pool stays usable after a failed loop */
+    pool.parallelFor(10, [&](size_t, size_t) { ++processed; });
+    REQUIRE(processed == 60);
+}
+
+TEST_CASE("BatchRunner::ReadsNdjsonSkippingBlankLines", "[BatchRunner]") {
+    std::istringstream input(sceneJson(1) + "\n\n  \n" + sceneJson(2) + "\n");
+    auto scenes = BatchRunner::readNdjson(input);
+    REQUIRE(scenes.size() == 2);
+    REQUIRE(scenes[0].name == "line 1");
+    REQUIRE(scenes[1].name == "line 4");
+    REQUIRE(scenes[1].json == sceneJson(2));
+}
+
+TEST_CASE("BatchRunner::FinderReuseDiscardsPreviousScene", "[BatchRunner]") {
+    IntersectionFinder finder;
+    std::ostringstream info;
+
+    std::istringstream first(sceneJson(2));
+    finder.loadRectanglesFromStream(first, 0, info);
+    finder.processIntersections();
+    REQUIRE(finder.intersections().size() == 4);
+
+    std::istringstream second(sceneJson(50));
+    finder.loadRectanglesFromStream(second, 0, info);
+    finder.processIntersections();
+    REQUIRE(finder.intersections().size() == 1);
+    REQUIRE(info.str().empty());
+}
+
+TEST_CASE("BatchRunner::OutputsInInputOrder", "[BatchRunner]") {
+    std::vector<BatchScene> scenes;
+    std::string expected;
+    BatchOptions options;
+
+    for (int i = 0; i < 60; ++i) {
+        BatchScene scene;
+        scene.name = "line " + std::to_string(i + 1);
+        scene.json = (i == 17) ? std::string("{\"rects\": 5}") : sceneJson(i % 20);
+        scenes.push_back(scene);
+
+        /* Expected output is what a sequential run of the same scene prints */
+        std::ostringstream one;
+        one << "Scene " << scene.name << ":\n";
+        try {
+            IntersectionFinder finder;
+            std::istringstream document(scene.json);
+            BatchRunner::runScene(finder, options, document, one);
+        } catch (const std::exception& e) {
+            one << "Error: " << e.what() << "\n";
+        }
+        expected += one.str();
+    }
+
+    ThreadPool pool(4);
+    std::ostringstream out;
+    REQUIRE(BatchRunner::run(scenes, options, pool, out) == 1);
+    REQUIRE(out.str() == expected);
+}
+
+TEST_CASE("BatchRunner::ListsSceneFiles", "[BatchRunner]") {
+    std::string first = writeTempJson(sceneJson(1));
+    std::string second = writeTempJson(sceneJson(2));
+    std::string list = writeTempJson(second + "\n\n" + first + "\n");
+
+    auto scenes = BatchRunner::listScenes(list);
+    REQUIRE(scenes.size() == 2);
+    REQUIRE(scenes[0].name == second);
+    REQUIRE(scenes[1].name == first);
+    REQUIRE(scenes[0].json.empty());
+
+    BatchOptions options;
+    options.mode = "--count-pairs";
+    ThreadPool pool(2);
+    std::ostringstream out;
+    REQUIRE(BatchRunner::run(scenes, options, pool, out) == 0);
+    REQUIRE(out.str() == "Scene " + second + ":\nOverlapping pairs: 3\nScene " + first + ":\nOverlapping pairs: 3\n");
+
+    REQUIRE_THROWS_AS(BatchRunner::listScenes("missing_batch_list.txt"), std::runtime_error);
+
+    removeTempFile(first);
+    removeTempFile(second);
+    removeTempFile(list);
+}
@@ -0,0 +1,74 @@
+#include "../DepthQuery.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+namespace {
+    // Maximum depth over every candidate corner (left edge, top edge) of the input
+    size_t bruteForceDepth(const std::vector<Rectangle>& rects) {
+        size_t best = 0;
+        for (const auto& a : rects) {
+            for (const auto& b : rects) {
+                size_t depth = 0;
+                for (const auto& r : rects) {
+                    if (r.x() <= a.x() && a.x() < r.right() && r.y() <= b.y() && b.y() < r.bottom()) {
+                        ++depth;
+                    }
+                }
+                best = std::max(best, depth);
+            }
+        }
+        return best;
+    }
+}
+
+TEST_CASE("DepthQuery::EmptyInput", "[DepthQuery]") {
+    auto result = DepthQuery::findMaxDepth({});
+    REQUIRE(result.parent_ids.empty());
+}
+
+TEST_CASE("DepthQuery::FindsDeepestStackWithWitness", "[DepthQuery]") {
+    std::vector<Rectangle> rects = {
+        Rectangle(1, 100, 100, 250, 80),
+        Rectangle(2, 120, 200, 250, 150),
+        Rectangle(3, 140, 160, 250, 100),
+        Rectangle(4, 160, 140, 350, 190)
+    };
+    auto result = DepthQuery::findMaxDepth(rects);
+    REQUIRE(result.parent_ids.size() == 3);
+
+    // The witness lies inside the reported rectangles' common region
+    Rectangle common = result.rect;
+    for (int id : result.parent_ids) {
+        Rectangle overlap(-1, 0, 0, 0, 0);
+        REQUIRE(Rectangle::calculate_intersection(common, rects[id - 1], overlap));
+        REQUIRE(overlap.w() == common.w());
+        REQUIRE(overlap.h() == common.h());
+    }
+}
+
+TEST_CASE("DepthQuery::TouchingRectanglesDoNotStack", "[DepthQuery]") {
+    std::vector<Rectangle> rects = {
+        Rectangle(1, 0, 0, 10, 10),
+        Rectangle(2, 10, 0, 10, 10),
+        Rectangle(3, 0, 10, 10, 10)
+    };
+    REQUIRE(DepthQuery::findMaxDepth(rects).parent_ids.size() == 1);
+}
+
+TEST_CASE("DepthQuery::MatchesBruteForceOnRandomScenes", "[DepthQuery]") {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> position(0, 60);
+    std::uniform_int_distribution<int> size(1, 25);
+
+    for (int scene = 0; scene < 30; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int id = 1; id <= 60; ++id) {
+            rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        }
+        auto result = DepthQuery::findMaxDepth(rects);
+        REQUIRE(result.parent_ids.size() == bruteForceDepth(rects));
+    }
+}
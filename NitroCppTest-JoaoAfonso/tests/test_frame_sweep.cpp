@@ -0,0 +1,102 @@
+#include "../FrameSweep.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <utility>
+#include <random>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    std::vector<std::pair<int, int>> bruteForcePairs(const std::vector<Rectangle>& rects) {
+        std::vector<std::pair<int, int>> pairs;
+        Rectangle overlap(-1, 0, 0, 0, 0);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                if (Rectangle::calculate_intersection(rects[i], rects[j], overlap)) {
+                    pairs.emplace_back(std::min(rects[i].id(), rects[j].id()), std::max(rects[i].id(), rects[j].id()));
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    std::vector<std::pair<int, int>> pairsOf(const std::vector<IntersectionResult>& results) {
+        std::vector<std::pair<int, int>> pairs;
+        for (const auto& res : results) {
+            pairs.emplace_back(res.parent_ids[0], res.parent_ids[1]);
+        }
+        return pairs;
+    }
+}
+
+TEST_CASE("FrameSweep::InitialFrameMatchesPairwiseTest", "[FrameSweep]") {
+    std::vector<Rectangle> frame = {
+        Rectangle(1, 0, 0, 10, 10),
+        Rectangle(2, 5, 5, 10, 10),
+        Rectangle(3, 10, 0, 5, 5), // touches rectangles 1 and 2 only along edges
+        Rectangle(4, 100, 100, 1, 1)
+    };
+    FrameSweep sweep(frame);
+    REQUIRE(sweep.overlapCount() == 1);
+
+    auto overlaps = sweep.overlaps();
+    REQUIRE(pairsOf(overlaps) == bruteForcePairs(frame));
+    CHECK(overlaps[0].rect.x() == 5);
+    CHECK(overlaps[0].rect.w() == 5);
+}
+
+TEST_CASE("FrameSweep::ReportsAddedAndRemovedPairs", "[FrameSweep]") {
+    std::vector<Rectangle> frame = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 20, 0, 10, 10)};
+    FrameSweep sweep(frame);
+    REQUIRE(sweep.overlapCount() == 0);
+
+    frame[1] = Rectangle(2, 8, 0, 10, 10);
+    sweep.update(frame);
+    REQUIRE(sweep.added() == std::vector<std::pair<int, int>>({{1, 2}}));
+    REQUIRE(sweep.removed().empty());
+
+    frame[1] = Rectangle(2, 8, 10, 10, 10); // slides down to touch only
+    sweep.update(frame);
+    REQUIRE(sweep.added().empty());
+    REQUIRE(sweep.removed() == std::vector<std::pair<int, int>>({{1, 2}}));
+
+    sweep.update(frame);
+    REQUIRE(sweep.swapCount() == 0);
+
+    REQUIRE_THROWS_AS(sweep.update({}), std::invalid_argument);
+}
+
+TEST_CASE("FrameSweep::TracksRandomMotion", "[FrameSweep]") {
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> position(0, 400);
+    std::uniform_int_distribution<int> size(5, 40);
+    std::uniform_int_distribution<int> jitter(-3, 3);
+
+    std::vector<Rectangle> frame;
+    for (int id = 1; id <= 150; ++id) {
+        frame.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+    }
+    FrameSweep sweep(frame);
+    auto expected = bruteForcePairs(frame);
+    REQUIRE(pairsOf(sweep.overlaps()) == expected);
+
+    for (int step = 0; step < 40; ++step) {
+        for (auto& rect : frame) {
+            rect = Rectangle(rect.id(), rect.x() + jitter(rng), rect.y() + jitter(rng), rect.w(), rect.h());
+        }
+        sweep.update(frame);
+
+        auto current = bruteForcePairs(frame);
+        std::vector<std::pair<int, int>> added, removed;
+        std::set_difference(current.begin(), current.end(), expected.begin(), expected.end(), std::back_inserter(added));
+        std::set_difference(expected.begin(), expected.end(), current.begin(), current.end(), std::back_inserter(removed));
+
+        REQUIRE(sweep.added() == added);
+        REQUIRE(sweep.removed() == removed);
+        REQUIRE(sweep.overlapCount() == current.size());
+        REQUIRE(pairsOf(sweep.overlaps()) == current);
+        expected = current;
+    }
+}
@@ -0,0 +1,134 @@
+#include "../IndexSnapshot.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    const char* kSnapshotPath = "temp_index_snapshot.nrix";
+
+    std::vector<int> bruteForceQuery(const std::vector<Rectangle>& rects, const Rectangle& window) {
+        std::vector<int> ids;
+        Rectangle overlap(-1, 0, 0, 0, 0);
+        for (const auto& r : rects) {
+            if (Rectangle::calculate_intersection(r, window, overlap)) {
+                ids.push_back(r.id());
+            }
+        }
+        return ids;
+    }
+}
+
+TEST_CASE("IndexSnapshot::QueriesMatchBruteForce", "[IndexSnapshot]") {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> coord(-500, 500);
+    std::uniform_int_distribution<int> side(1, 40);
+
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 400; ++id) {
+        rects.emplace_back(id, coord(rng), coord(rng), side(rng), side(rng));
+    }
+    /* Rectangles spanning most of the scene go to the large list */
+    rects.emplace_back(401, -600, -600, 1200, 1200);
+    rects.emplace_back(402, -500, 0, 1000, 3);
+
+    IndexSnapshot::write(kSnapshotPath, rects);
+    REQUIRE(IndexSnapshot::isSnapshot(kSnapshotPath));
+
+    IndexSnapshot snapshot = IndexSnapshot::open(kSnapshotPath);
+    REQUIRE(snapshot.size() == rects.size());
+
+    auto stored = snapshot.rectangles();
+    for (size_t i = 0; i < rects.size(); ++i) {
+        REQUIRE(stored[i].id() == rects[i].id());
+        REQUIRE(stored[i].x() == rects[i].x());
+        REQUIRE(stored[i].h() == rects[i].h());
+    }
+
+    for (int q = 0; q < 300; ++q) {
+        Rectangle window(-1, coord(rng) * 2, coord(rng) * 2, side(rng) * (q % 5 + 1), side(rng));
+        REQUIRE(snapshot.query(window) == bruteForceQuery(rects, window));
+    }
+    REQUIRE(snapshot.stab(-599, -599) == std::vector<int>{401});
+    REQUIRE(snapshot.query(Rectangle(-1, 5000, 5000, 10, 10)).empty());
+
+    /* Moving keeps the mapping alive */
+    IndexSnapshot moved = std::move(snapshot);
+    REQUIRE(moved.stab(-599, -599) == std::vector<int>{401});
+
+    std::remove(kSnapshotPath);
+}
+
+TEST_CASE("IndexSnapshot::ElongatedSceneKeepsGridSmall", "[IndexSnapshot]") {
+    /* A long thin strip: sizing cells by area alone would give a million columns */
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 1000; ++id) {
+        rects.emplace_back(id, (id - 1) * 1000000, id % 2, 1500000, 1);
+    }
+
+    IndexSnapshot::write(kSnapshotPath, rects);
+    IndexSnapshot::Header header;
+    {
+        std::ifstream in(kSnapshotPath, std::ios::binary);
+        REQUIRE(in.read(reinterpret_cast<char*>(&header), sizeof(header)));
+    }
+    REQUIRE(header.columns * header.rows <= 3 * rects.size() + 2);
+
+    IndexSnapshot snapshot = IndexSnapshot::open(kSnapshotPath);
+    for (int q = 0; q < 50; ++q) {
+        Rectangle window(-1, q * 19999999, 0, 3000000, 2);
+        REQUIRE(snapshot.query(window) == bruteForceQuery(rects, window));
+    }
+    std::remove(kSnapshotPath);
+}
+
+TEST_CASE("IndexSnapshot::EmptyScene", "[IndexSnapshot]") {
+    IndexSnapshot::write(kSnapshotPath, {});
+    IndexSnapshot snapshot = IndexSnapshot::open(kSnapshotPath);
+    REQUIRE(snapshot.size() == 0);
+    REQUIRE(snapshot.stab(0, 0).empty());
+    std::remove(kSnapshotPath);
+}
+
+TEST_CASE("IndexSnapshot::RejectsInvalidFiles", "[IndexSnapshot]") {
+    REQUIRE_THROWS_AS(IndexSnapshot::open("missing_snapshot.nrix"), std::runtime_error);
+
+    {
+        std::ofstream out(kSnapshotPath, std::ios::binary);
+        out << "{\"rects\": []}";
+    }
+    REQUIRE_FALSE(IndexSnapshot::isSnapshot(kSnapshotPath));
+    REQUIRE_THROWS_AS(IndexSnapshot::open(kSnapshotPath), std::runtime_error);
+
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10)};
+    IndexSnapshot::write(kSnapshotPath, rects);
+
+    /* Truncated file */
+    std::vector<char> bytes;
+    {
+        std::ifstream in(kSnapshotPath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(kSnapshotPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+    }
+    REQUIRE_THROWS_AS(IndexSnapshot::open(kSnapshotPath), std::runtime_error);
+
+    /* Future layout version */
+    IndexSnapshot::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.version = INDEX_SNAPSHOT_VERSION + 1;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    {
+        std::ofstream out(kSnapshotPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    REQUIRE_THROWS_AS(IndexSnapshot::open(kSnapshotPath), std::runtime_error);
+
+    std::remove(kSnapshotPath);
+}
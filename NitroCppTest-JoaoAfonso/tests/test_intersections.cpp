@@ -2,12 +2,19 @@
 #include "../IntersectionFinder.h"
 #include "../Rectangle.h"
 #undef private // Restore private access after testing
+#include "../RunStats.h"
+#include "../ThreadPool.h"
+#include "../WorkloadGenerator.h"
+#include "../SubsetEngine.h"
 #include <catch2/catch_test_macros.hpp>
+#include <climits>
 #include <fstream>
 #include <cstdio>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdint>
+#include <random>
 #include "test_helpers.h"
 
 TEST_CASE("IntersectionFinder::LoadRectanglesFromFileThrowsOnSingleRectangle", "[IntersectionFinder]") {
@@ -37,7 +44,7 @@ TEST_CASE("IntersectionFinder::LoadRectanglesFromFileLoadsMultipleRectangles", "
 
 TEST_CASE("IntersectionFinder::CreateKeySortsAndJoinsIds", "[IntersectionFinder]") {
     IntersectionFinder finder;
-    std::vector<int> ids = {3, 1, 2};
+    std::pmr::vector<int> ids = {3, 1, 2};
     std::string key = finder.createKey(ids);
     REQUIRE(key == "1-2-3");
 }
@@ -45,10 +52,10 @@ TEST_CASE("IntersectionFinder::CreateKeySortsAndJoinsIds", "[IntersectionFinder]
 TEST_CASE("IntersectionFinder::RecordIntersectionIfUniqueWorks", "[IntersectionFinder]") {
     IntersectionFinder finder;
     Rectangle r1(1, 0, 0, 10, 10);
-    std::vector<int> ids = {2, 1};
-    REQUIRE(finder.recordIntersectionIfUnique(r1, ids));
+    std::pmr::vector<int> ids = {2, 1};
+    REQUIRE(finder.recordIntersectionIfUnique(r1, std::pmr::vector<int>(ids)));
     // Should not record again
-    REQUIRE_FALSE(finder.recordIntersectionIfUnique(r1, ids));
+    REQUIRE_FALSE(finder.recordIntersectionIfUnique(r1, std::pmr::vector<int>(ids)));
 }
 
 TEST_CASE("IntersectionFinder::ProcessIntersectionsFindsCorrectIntersections", "[IntersectionFinder]") {
@@ -109,7 +116,7 @@ TEST_CASE("IntersectionFinder::RecursiveIntersections", "[IntersectionFinder]")
     bool found = false;
     for (const auto& res : finder.m_intersections) {
         if (res.parent_ids.size() == 3) {
-            std::vector<int> ids = res.parent_ids;
+            std::vector<int> ids(res.parent_ids.begin(), res.parent_ids.end());
             std::sort(ids.begin(), ids.end());
             if (ids == std::vector<int>({1,2,3})) {
                 REQUIRE(res.rect.x() == 2);
@@ -123,4 +130,425 @@ TEST_CASE("IntersectionFinder::RecursiveIntersections", "[IntersectionFinder]")
     REQUIRE(found);
     removeTempFile(filename);
 }
-   
\ No newline at end of file
+
+TEST_CASE("IntersectionFinder::MaximalIntersectionsReportsOnlyMaximalGroups", "[IntersectionFinder]") {
+    std::string json = R"({
+        "rects": [
+            {"x": 0, "y": 0, "w": 10, "h": 10},
+            {"x": 1, "y": 1, "w": 10, "h": 10},
+            {"x": 2, "y": 2, "w": 10, "h": 10},
+            {"x": 3, "y": 3, "w": 10, "h": 10},
+            {"x": 100, "y": 100, "w": 5, "h": 5},
+            {"x": 102, "y": 102, "w": 5, "h": 5},
+            {"x": 200, "y": 200, "w": 5, "h": 5}
+        ]
+    })";
+    std::string filename = writeTempJson(json);
+    IntersectionFinder finder;
+    finder.loadRectanglesFromFile(filename);
+    finder.processMaximalIntersections();
+    REQUIRE(finder.m_intersections.size() == 2);
+
+    std::vector<std::vector<int>> groups;
+    for (const auto& res : finder.m_intersections) {
+        std::vector<int> ids(res.parent_ids.begin(), res.parent_ids.end());
+        std::sort(ids.begin(), ids.end());
+        groups.push_back(ids);
+        if (ids.size() == 4) {
+            REQUIRE(res.rect.x() == 3);
+            REQUIRE(res.rect.y() == 3);
+            REQUIRE(res.rect.w() == 7);
+            REQUIRE(res.rect.h() == 7);
+        }
+    }
+    std::sort(groups.begin(), groups.end());
+    REQUIRE(groups == std::vector<std::vector<int>>({{1, 2, 3, 4}, {5, 6}}));
+    removeTempFile(filename);
+}
+
+TEST_CASE("IntersectionFinder::ReusedFinderReplacesResultsAcrossModes", "[IntersectionFinder]") {
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10), Rectangle(3, 8, 8, 10, 10)};
+    IntersectionFinder finder;
+    finder.loadRectangles(std::vector<Rectangle>(rects));
+
+    finder.processIntersections();
+    REQUIRE(finder.intersections().size() == 4);
+
+    /* One maximal group, whatever ran before */
+    finder.processMaximalIntersections();
+    REQUIRE(finder.intersections().size() == 1);
+    REQUIRE(std::vector<int>(finder.intersections()[0].parent_ids.begin(), finder.intersections()[0].parent_ids.end()) == std::vector<int>({1, 2, 3}));
+    finder.processMaximalIntersections();
+    REQUIRE(finder.intersections().size() == 1);
+
+    finder.processIntersections();
+    REQUIRE(finder.intersections().size() == 4);
+}
+
+TEST_CASE("IntersectionFinder::MaximalIntersectionsMatchesFullEnumeration", "[IntersectionFinder]") {
+    std::string filename = writeTempJson(R"({
+        "rects": [
+            {"x": 100, "y": 100, "w": 250, "h": 80 },
+            {"x": 120, "y": 200, "w": 250, "h": 150 },
+            {"x": 140, "y": 160, "w": 250, "h": 100 },
+            {"x": 160, "y": 140, "w": 350, "h": 190 },
+            {"x": 0, "y": 0, "w": 130, "h": 130 },
+            {"x": 300, "y": 0, "w": 20, "h": 400 }
+        ]
+    })");
+
+    IntersectionFinder full;
+    full.loadRectanglesFromFile(filename);
+    full.processIntersections();
+
+    IntersectionFinder maximal;
+    maximal.loadRectanglesFromFile(filename);
+    maximal.processMaximalIntersections();
+
+    /* A group from the full enumeration is maximal if no other group strictly contains it */
+    std::vector<std::vector<int>> all_groups;
+    for (const auto& res : full.m_intersections) {
+        std::vector<int> ids(res.parent_ids.begin(), res.parent_ids.end());
+        std::sort(ids.begin(), ids.end());
+        all_groups.push_back(ids);
+    }
+    std::vector<std::vector<int>> expected;
+    for (const auto& group : all_groups) {
+        bool contained = false;
+        for (const auto& other : all_groups) {
+            if (other.size() > group.size() &&
+                std::includes(other.begin(), other.end(), group.begin(), group.end())) {
+                contained = true;
+            }
+        }
+        if (!contained) {
+            expected.push_back(group);
+        }
+    }
+
+    std::vector<std::vector<int>> actual;
+    for (const auto& res : maximal.m_intersections) {
+        std::vector<int> ids(res.parent_ids.begin(), res.parent_ids.end());
+        std::sort(ids.begin(), ids.end());
+        actual.push_back(ids);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    REQUIRE(actual == expected);
+    removeTempFile(filename);
+}
+
+TEST_CASE("IntersectionFinder::InsertMatchesFullRecomputation", "[IntersectionFinder]") {
+    std::vector<Rectangle> rects = {
+        Rectangle(0, 100, 100, 250, 80),
+        Rectangle(0, 120, 200, 250, 150),
+        Rectangle(0, 140, 160, 250, 100),
+        Rectangle(0, 160, 140, 350, 190),
+        Rectangle(0, 150, 150, 30, 300),
+        Rectangle(0, 1000, 1000, 10, 10)
+    };
+
+    IntersectionFinder incremental;
+    size_t reported = 0;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        std::vector<IntersectionResult> new_groups;
+        int id = incremental.insert(rects[i], new_groups);
+        REQUIRE(id == static_cast<int>(i + 1));
+        for (const auto& group : new_groups) {
+            REQUIRE(group.parent_ids.back() == id);
+        }
+        reported += new_groups.size();
+    }
+    REQUIRE(incremental.m_intersections.size() == reported);
+
+    std::string json = R"({"rects":[)";
+    for (size_t i = 0; i < rects.size(); ++i) {
+        json += "{\"x\":" + std::to_string(rects[i].x()) + ",\"y\":" + std::to_string(rects[i].y()) +
+                ",\"w\":" + std::to_string(rects[i].w()) + ",\"h\":" + std::to_string(rects[i].h()) + "}";
+        if (i + 1 != rects.size()) json += ",";
+    }
+    json += "]}";
+    std::string filename = writeTempJson(json);
+    IntersectionFinder full;
+    full.loadRectanglesFromFile(filename);
+    full.processIntersections();
+
+    auto normalize = [](const std::vector<IntersectionResult>& results) {
+        std::vector<std::vector<int>> rows;
+        for (const auto& res : results) {
+            std::vector<int> row(res.parent_ids.begin(), res.parent_ids.end());
+            std::sort(row.begin(), row.end());
+            row.push_back(res.rect.x());
+            row.push_back(res.rect.y());
+            row.push_back(res.rect.w());
+            row.push_back(res.rect.h());
+            rows.push_back(row);
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    };
+    REQUIRE(normalize(incremental.m_intersections) == normalize(full.m_intersections));
+    removeTempFile(filename);
+}
+
+TEST_CASE("IntersectionFinder::InsertRejectsEmptyRectangle", "[IntersectionFinder]") {
+    IntersectionFinder finder;
+    std::vector<IntersectionResult> new_groups;
+    REQUIRE_THROWS_AS(finder.insert(Rectangle(0, 0, 0, 0, 5), new_groups), std::invalid_argument);
+
+    // Edges past INT_MAX would overflow the intersection arithmetic
+    REQUIRE_THROWS_AS(finder.insert(Rectangle(0, INT_MAX - 4, 0, 10, 5), new_groups), std::invalid_argument);
+    REQUIRE_THROWS_AS(finder.insert(Rectangle(0, 0, INT_MAX, 5, 1), new_groups), std::invalid_argument);
+    REQUIRE(finder.insert(Rectangle(0, INT_MAX - 10, 0, 10, 5), new_groups) == 1);
+    REQUIRE_THROWS_AS(finder.move(1, Rectangle(0, INT_MAX, INT_MAX, INT_MAX, INT_MAX), new_groups), std::invalid_argument);
+}
+
+namespace {
+    // Every intersecting group of two or more rectangles, as sorted IDs followed by the region
+    std::vector<std::vector<int>> bruteForceGroups(const std::vector<Rectangle>& rects) {
+        std::vector<std::vector<int>> rows;
+        for (uint32_t mask = 1; mask < (1u << rects.size()); ++mask) {
+            std::vector<int> ids;
+            Rectangle common(-1, 0, 0, 0, 0);
+            bool empty = false;
+            for (size_t i = 0; i < rects.size() && !empty; ++i) {
+                if (mask & (1u << i)) {
+                    if (ids.empty()) {
+                        common = rects[i];
+                    } else if (!Rectangle::calculate_intersection(common, rects[i], common)) {
+                        empty = true;
+                    }
+                    ids.push_back(rects[i].id());
+                }
+            }
+            if (!empty && ids.size() >= 2) {
+                std::sort(ids.begin(), ids.end());
+                ids.insert(ids.end(), {common.x(), common.y(), common.w(), common.h()});
+                rows.push_back(ids);
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    std::vector<std::vector<int>> storedGroups(const IntersectionFinder& finder) {
+        std::vector<std::vector<int>> rows;
+        for (const auto& res : finder.m_intersections) {
+            std::vector<int> row(res.parent_ids.begin(), res.parent_ids.end());
+            REQUIRE(std::is_sorted(row.begin(), row.end()));
+            row.insert(row.end(), {res.rect.x(), res.rect.y(), res.rect.w(), res.rect.h()});
+            rows.push_back(row);
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+}
+
+TEST_CASE("IntersectionFinder::EraseAndMoveUpdateGroupsInPlace", "[IntersectionFinder]") {
+    std::string filename = writeTempJson(R"({
+        "rects": [
+            {"x": 100, "y": 100, "w": 250, "h": 80 },
+            {"x": 120, "y": 200, "w": 250, "h": 150 },
+            {"x": 140, "y": 160, "w": 250, "h": 100 },
+            {"x": 160, "y": 140, "w": 350, "h": 190 },
+            {"x": 150, "y": 150, "w": 30, "h": 300 }
+        ]
+    })");
+    IntersectionFinder finder;
+    finder.loadRectanglesFromFile(filename);
+    finder.processIntersections();
+    removeTempFile(filename);
+
+    std::vector<Rectangle> scene = finder.m_inputRectangles;
+    REQUIRE(storedGroups(finder) == bruteForceGroups(scene));
+
+    // Move rectangle 3 away from everything, then back over rectangles 1 and 5
+    std::vector<IntersectionResult> new_groups;
+    REQUIRE(finder.move(3, Rectangle(0, 2000, 2000, 10, 10), new_groups));
+    REQUIRE(new_groups.empty());
+    scene[2] = Rectangle(3, 2000, 2000, 10, 10);
+    REQUIRE(storedGroups(finder) == bruteForceGroups(scene));
+
+    REQUIRE(finder.move(3, Rectangle(0, 90, 90, 80, 80), new_groups));
+    REQUIRE_FALSE(new_groups.empty());
+    scene[2] = Rectangle(3, 90, 90, 80, 80);
+    REQUIRE(storedGroups(finder) == bruteForceGroups(scene));
+
+    REQUIRE(finder.erase(4));
+    REQUIRE_FALSE(finder.erase(4));
+    scene.erase(scene.begin() + 3);
+    REQUIRE(storedGroups(finder) == bruteForceGroups(scene));
+    REQUIRE(finder.m_inputRectangles.size() == scene.size());
+
+    // Inserting after removals keeps IDs unique and results consistent
+    int id = finder.insert(Rectangle(0, 130, 130, 100, 100), new_groups);
+    REQUIRE(id == 6);
+    scene.emplace_back(6, 130, 130, 100, 100);
+    REQUIRE(storedGroups(finder) == bruteForceGroups(scene));
+
+    REQUIRE_FALSE(finder.move(42, Rectangle(0, 0, 0, 1, 1), new_groups));
+}
+
+TEST_CASE("IntersectionFinder::EnumerationAllocatesNothingPerResult", "[IntersectionFinder]") {
+    // 14 rectangles over a common point: all 2^14 - 15 groups of two or more intersect
+    std::vector<Rectangle> rects;
+    for (int i = 0; i < 14; ++i) {
+        rects.emplace_back(i + 1, i, i, 100, 100);
+    }
+    IntersectionFinder finder;
+    finder.loadRectangles(std::vector<Rectangle>(rects));
+
+    // Cold run: only the arena and the result vector grow, geometrically
+    uint64_t before = RunStats::threadAllocations();
+    finder.processIntersections();
+    uint64_t cold = RunStats::threadAllocations() - before;
+    const uint64_t results = finder.intersections().size();
+    REQUIRE(results == 16369);
+    REQUIRE(cold / results == 0);
+    REQUIRE(cold < 64);
+
+    // Warm run: the results reuse the arena blocks and the vector capacity of the previous run
+    before = RunStats::threadAllocations();
+    finder.processIntersections();
+    uint64_t warm = RunStats::threadAllocations() - before;
+    REQUIRE(finder.intersections().size() == results);
+    REQUIRE(warm <= 1);
+}
+
+TEST_CASE("IntersectionFinder::ResultsLiveInSuppliedResource", "[IntersectionFinder]") {
+    // Results must fit the buffer: the null upstream throws on any allocation outside it
+    std::vector<char> buffer(1 << 16);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    IntersectionFinder finder(&arena);
+    REQUIRE(finder.memoryResource() == &arena);
+
+    for (int scene = 0; scene < 3; ++scene) {
+        finder.clearResults();
+        arena.release();
+
+        std::vector<Rectangle> rects;
+        for (int i = 0; i < 6; ++i) {
+            rects.emplace_back(i + 1, i * (scene + 1), 0, 100, 100);
+        }
+        finder.loadRectangles(std::move(rects));
+        finder.processIntersections();
+        REQUIRE(finder.intersections().size() == 57);
+        for (const auto& group : finder.intersections()) {
+            REQUIRE(group.parent_ids.get_allocator().resource() == &arena);
+        }
+    }
+
+    finder.processArrangementCells();
+    REQUIRE_FALSE(finder.intersections().empty());
+    REQUIRE(finder.intersections()[0].parent_ids.get_allocator().resource() == &arena);
+}
+
+namespace {
+    // The depth-first order of the former recursive search: a group, then its extensions by later rectangles
+    void recursiveOrder(const std::vector<Rectangle>& rects, const Rectangle& region, std::vector<int>& ids,
+                        size_t start, std::vector<std::vector<int>>& order) {
+        for (size_t i = start; i < rects.size(); ++i) {
+            Rectangle next(-1, 0, 0, 0, 0);
+            if (Rectangle::calculate_intersection(region, rects[i], next)) {
+                ids.push_back(rects[i].id());
+                order.push_back(ids);
+                recursiveOrder(rects, next, ids, i + 1, order);
+                ids.pop_back();
+            }
+        }
+    }
+}
+
+TEST_CASE("IntersectionFinder::EnumerationKeepsDepthFirstOrder", "[IntersectionFinder]") {
+    uint32_t state = 12345;
+    auto next = [&state](int range) {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 8) % static_cast<uint32_t>(range));
+    };
+
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int i = 0; i < 10; ++i) {
+            rects.emplace_back(i + 1, next(100), next(100), 1 + next(60), 1 + next(60));
+        }
+
+        std::vector<std::vector<int>> expected;
+        std::vector<int> ids;
+        for (size_t i = 0; i < rects.size(); ++i) {
+            ids.assign(1, rects[i].id());
+            recursiveOrder(rects, rects[i], ids, i + 1, expected);
+        }
+
+        IntersectionFinder finder;
+        finder.loadRectangles(std::vector<Rectangle>(rects));
+        finder.processIntersections();
+        REQUIRE(finder.intersections().size() == expected.size());
+        for (size_t k = 0; k < expected.size(); ++k) {
+            const auto& group = finder.intersections()[k].parent_ids;
+            REQUIRE(std::vector<int>(group.begin(), group.end()) == expected[k]);
+        }
+    }
+}
+
+TEST_CASE("IntersectionFinder::ParallelComponentsKeepSerialOrder", "[IntersectionFinder]") {
+    ThreadPool pool(4);
+    for (Workload kind : {Workload::Uniform, Workload::Clustered, Workload::Nested}) {
+        WorkloadParams params;
+        params.kind = kind;
+        params.count = 300;
+        params.seed = 3;
+        params.density = 0.3;
+        std::vector<Rectangle> rects = WorkloadGenerator::generate(params);
+
+        IntersectionFinder serial;
+        serial.loadRectangles(std::vector<Rectangle>(rects));
+        serial.processIntersections();
+
+        IntersectionFinder parallel;
+        parallel.loadRectangles(std::vector<Rectangle>(rects));
+        parallel.processIntersections(&pool);
+        REQUIRE(parallel.m_components.componentCount() > 1);
+
+        REQUIRE(parallel.intersections().size() == serial.intersections().size());
+        for (size_t k = 0; k < serial.intersections().size(); ++k) {
+            const Rectangle& got = parallel.intersections()[k].rect;
+            const Rectangle& want = serial.intersections()[k].rect;
+            REQUIRE((got.x() == want.x() && got.y() == want.y() && got.w() == want.w() && got.h() == want.h()));
+            REQUIRE(parallel.intersections()[k].parent_ids == serial.intersections()[k].parent_ids);
+        }
+
+        /* A second run reuses the finder and its search state */
+        parallel.processIntersections(&pool);
+        REQUIRE(parallel.intersections().size() == serial.intersections().size());
+    }
+}
+
+TEST_CASE("IntersectionFinder::SmallScenesMatchComponentSearch", "[IntersectionFinder]") {
+    std::mt19937 rng(11);
+    for (size_t count = 2; count <= SUBSET_ENGINE_MAX_SIZE; ++count) {
+        for (int spread : {20, 60, 200}) {
+            std::uniform_int_distribution<int> position(-spread, spread);
+            std::uniform_int_distribution<int> side(1, 50);
+            std::vector<Rectangle> rects;
+            for (size_t i = 0; i < count; ++i) {
+                rects.emplace_back(static_cast<int>(i) + 1, position(rng), position(rng), side(rng), side(rng));
+            }
+
+            IntersectionFinder small;
+            small.loadRectangles(std::vector<Rectangle>(rects));
+            small.processIntersections();
+
+            IntersectionFinder generic;
+            generic.loadRectangles(std::vector<Rectangle>(rects));
+            generic.searchComponents(nullptr);
+
+            REQUIRE(small.intersections().size() == generic.intersections().size());
+            for (size_t k = 0; k < generic.intersections().size(); ++k) {
+                const Rectangle& got = small.intersections()[k].rect;
+                const Rectangle& want = generic.intersections()[k].rect;
+                REQUIRE((got.x() == want.x() && got.y() == want.y() && got.w() == want.w() && got.h() == want.h()));
+                REQUIRE(small.intersections()[k].parent_ids == generic.intersections()[k].parent_ids);
+            }
+        }
+    }
+}
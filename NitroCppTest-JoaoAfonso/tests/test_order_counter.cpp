@@ -0,0 +1,86 @@
+#include "../OrderCounter.h"
+#include "../BigUnsigned.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    // Counts intersecting subsets of each size by walking every subset (small inputs only)
+    std::vector<uint64_t> bruteForceCounts(const std::vector<Rectangle>& rects) {
+        std::vector<uint64_t> counts(rects.size() + 1, 0);
+        for (uint32_t mask = 1; mask < (1u << rects.size()); ++mask) {
+            int left = INT32_MIN, top = INT32_MIN, right = INT32_MAX, bottom = INT32_MAX;
+            size_t members = 0;
+            for (size_t i = 0; i < rects.size(); ++i) {
+                if (mask & (1u << i)) {
+                    left = std::max(left, rects[i].x());
+                    top = std::max(top, rects[i].y());
+                    right = std::min(right, rects[i].right());
+                    bottom = std::min(bottom, rects[i].bottom());
+                    ++members;
+                }
+            }
+            if (left < right && top < bottom) {
+                ++counts[members];
+            }
+        }
+        while (!counts.empty() && counts.back() == 0) {
+            counts.pop_back();
+        }
+        return counts;
+    }
+}
+
+TEST_CASE("BigUnsigned::ArithmeticAndFormatting", "[BigUnsigned]") {
+    BigUnsigned two_to_64 = BigUnsigned(UINT64_MAX) + BigUnsigned(1);
+    CHECK(two_to_64.toString() == "18446744073709551616");
+    CHECK((two_to_64 * two_to_64).toString() == "340282366920938463463374607431768211456");
+    CHECK(BigUnsigned(0).toString() == "0");
+    CHECK(BigUnsigned(1000000000).toString() == "1000000000");
+
+    uint64_t value = 0;
+    CHECK(BigUnsigned(UINT64_MAX).toUint64(value));
+    CHECK(value == UINT64_MAX);
+    CHECK_FALSE(two_to_64.toUint64(value));
+
+    CHECK(BigUnsigned(5) < two_to_64);
+    CHECK(two_to_64 > BigUnsigned(UINT64_MAX));
+    CHECK(BigUnsigned(7) == BigUnsigned(3) + BigUnsigned(4));
+}
+
+TEST_CASE("OrderCounter::MatchesSubsetEnumerationOnRandomScenes", "[OrderCounter]") {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> position(0, 20);
+    std::uniform_int_distribution<int> size(1, 12);
+
+    for (int scene = 0; scene < 50; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int id = 1; id <= 12; ++id) {
+            rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        }
+        auto expected = bruteForceCounts(rects);
+        auto counts = OrderCounter::countByOrder(rects);
+
+        REQUIRE(counts.size() == expected.size());
+        for (size_t k = 0; k < counts.size(); ++k) {
+            REQUIRE(counts[k] == BigUnsigned(expected[k]));
+        }
+    }
+}
+
+TEST_CASE("OrderCounter::CountsBeyondSixtyFourBits", "[OrderCounter]") {
+    // 100 identical rectangles: every subset intersects, so the total is 2^100 - 100 - 1
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 100; ++id) {
+        rects.emplace_back(id, 0, 0, 10, 10);
+    }
+    auto counts = OrderCounter::countByOrder(rects);
+    REQUIRE(counts.size() == 101);
+    CHECK(counts[1] == BigUnsigned(100));
+    CHECK(counts[2] == BigUnsigned(4950));
+    CHECK(counts[100] == BigUnsigned(1));
+    CHECK(OrderCounter::totalIntersections(counts).toString() == "1267650600228229401496703205275");
+}
@@ -0,0 +1,112 @@
+#include "../OverlapComponents.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+
+namespace {
+    /* Feeds every overlapping pair of 'rects' in pairwise-pass order */
+    void addAllPairs(OverlapComponents& components, const std::vector<Rectangle>& rects) {
+        components.reset(rects.size());
+        for (size_t i = 0; i < rects.size(); ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                Rectangle region(-1, 0, 0, 0, 0);
+                if (Rectangle::calculate_intersection(rects[i], rects[j], region)) {
+                    components.addPair(i, j, region);
+                }
+            }
+        }
+        components.finish();
+    }
+}
+
+TEST_CASE("OverlapComponents::GroupsChainedOverlaps", "[OverlapComponents]") {
+    /* 0-1-2 chained (0 and 2 apart), 3 alone, 4-5 overlapping */
+    std::vector<Rectangle> rects = {
+        Rectangle(1, 0, 0, 10, 10),
+        Rectangle(2, 8, 0, 10, 10),
+        Rectangle(3, 16, 0, 10, 10),
+        Rectangle(4, 100, 100, 5, 5),
+        Rectangle(5, 200, 200, 10, 10),
+        Rectangle(6, 205, 205, 10, 10)
+    };
+    OverlapComponents components;
+    addAllPairs(components, rects);
+
+    REQUIRE(components.componentCount() == 3);
+    REQUIRE(components.componentOf(0) == 0);
+    REQUIRE(components.componentOf(2) == 0);
+    REQUIRE(components.componentOf(3) == 1);
+    REQUIRE(components.componentOf(5) == 2);
+    REQUIRE(components.componentSize(0) == 3);
+    REQUIRE(components.componentSize(1) == 1);
+    REQUIRE(components.members(2)[0] == 4);
+    REQUIRE(components.members(2)[1] == 5);
+    REQUIRE(components.positionOf(2) == 2);
+    REQUIRE(components.positionOf(5) == 1);
+
+    /* Pairs stay under their first rectangle, with their common region */
+    REQUIRE(components.pairsEnd(0) - components.pairsBegin(0) == 1);
+    REQUIRE(components.pairsBegin(0)->second == 1);
+    REQUIRE(components.pairsBegin(0)->region.x() == 8);
+    REQUIRE(components.pairsEnd(2) == components.pairsBegin(2));
+    REQUIRE(components.pairsEnd(3) == components.pairsBegin(3));
+    REQUIRE(components.pairsBegin(4)->second == 5);
+}
+
+TEST_CASE("OverlapComponents::ResetForgetsPreviousPass", "[OverlapComponents]") {
+    OverlapComponents components;
+    addAllPairs(components, {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10)});
+    REQUIRE(components.componentCount() == 1);
+
+    addAllPairs(components, {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 50, 50, 10, 10), Rectangle(3, 90, 90, 1, 1)});
+    REQUIRE(components.componentCount() == 3);
+    for (size_t i = 0; i < 3; ++i) {
+        REQUIRE(components.componentOf(i) == i);
+        REQUIRE(components.pairsEnd(i) == components.pairsBegin(i));
+    }
+}
+
+TEST_CASE("OverlapComponents::MatchesGraphSearch", "[OverlapComponents]") {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> position(0, 500);
+    std::uniform_int_distribution<int> side(1, 40);
+
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int i = 0; i < 60; ++i) {
+            rects.emplace_back(i + 1, position(rng), position(rng), side(rng), side(rng));
+        }
+        OverlapComponents components;
+        addAllPairs(components, rects);
+
+        /* Reference labels: flood fill over the overlap graph, numbered by lowest index */
+        std::vector<size_t> label(rects.size(), rects.size());
+        size_t labels = 0;
+        for (size_t start = 0; start < rects.size(); ++start) {
+            if (label[start] != rects.size()) {
+                continue;
+            }
+            std::vector<size_t> pending = {start};
+            label[start] = labels;
+            while (!pending.empty()) {
+                size_t current = pending.back();
+                pending.pop_back();
+                for (size_t other = 0; other < rects.size(); ++other) {
+                    Rectangle region(-1, 0, 0, 0, 0);
+                    if (label[other] == rects.size() && Rectangle::calculate_intersection(rects[current], rects[other], region)) {
+                        label[other] = labels;
+                        pending.push_back(other);
+                    }
+                }
+            }
+            ++labels;
+        }
+
+        REQUIRE(components.componentCount() == labels);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            REQUIRE(components.componentOf(i) == label[i]);
+            REQUIRE(components.members(label[i])[components.positionOf(i)] == i);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "../OverlapCounter.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+
+namespace {
+    uint64_t bruteForcePairs(const std::vector<Rectangle>& rects) {
+        uint64_t pairs = 0;
+        Rectangle overlap(-1, 0, 0, 0, 0);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                if (Rectangle::calculate_intersection(rects[i], rects[j], overlap)) {
+                    ++pairs;
+                }
+            }
+        }
+        return pairs;
+    }
+}
+
+TEST_CASE("OverlapCounter::EmptyInputHasNoPairs", "[OverlapCounter]") {
+    REQUIRE(OverlapCounter::countOverlappingPairs({}) == 0);
+}
+
+TEST_CASE("OverlapCounter::TouchingRectanglesDoNotCount", "[OverlapCounter]") {
+    std::vector<Rectangle> rects = {
+        Rectangle(1, 0, 0, 10, 10),
+        Rectangle(2, 10, 0, 10, 10),
+        Rectangle(3, 0, 10, 10, 10),
+        Rectangle(4, 10, 10, 10, 10)
+    };
+    REQUIRE(OverlapCounter::countOverlappingPairs(rects) == 0);
+}
+
+TEST_CASE("OverlapCounter::IdenticalRectanglesAllOverlap", "[OverlapCounter]") {
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 50; ++id) {
+        rects.emplace_back(id, 3, 3, 7, 7);
+    }
+    REQUIRE(OverlapCounter::countOverlappingPairs(rects) == 50 * 49 / 2);
+}
+
+TEST_CASE("OverlapCounter::MatchesPairwiseTestOnRandomScenes", "[OverlapCounter]") {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> position(-50, 50);
+    std::uniform_int_distribution<int> size(1, 30);
+
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int id = 1; id <= 200; ++id) {
+            rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        }
+        REQUIRE(OverlapCounter::countOverlappingPairs(rects) == bruteForcePairs(rects));
+    }
+}
@@ -0,0 +1,145 @@
+#include "../PipelineRunner.h"
+#include "../BoundedQueue.h"
+#include "../BatchRunner.h"
+#include "../ThreadPool.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SpscQueue::FifoWithBackpressure", "[BoundedQueue]") {
+    SpscQueue<int> queue(3);
+
+    /* Capacity is rounded up to a power of two */
+    int value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = i;
+        REQUIRE(queue.tryPush(value));
+    }
+    value = 99;
+    REQUIRE_FALSE(queue.tryPush(value));
+    REQUIRE(value == 99);
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.tryPop(value));
+
+    const int count = 100000;
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; ++i) {
+            queue.push(i);
+        }
+    });
+
+    bool ordered = true;
+    for (int i = 0; i < count; ++i) {
+        queue.pop(value);
+        ordered = ordered && value == i;
+    }
+    producer.join();
+    REQUIRE(ordered);
+}
+
+TEST_CASE("MpmcQueue::DeliversEveryElementOnce", "[BoundedQueue]") {
+    MpmcQueue<int> queue(16);
+    const int producers = 3;
+    const int consumers = 3;
+    const int per_producer = 20000;
+
+    std::vector<std::atomic<int>> seen(producers * per_producer);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(p * per_producer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&queue, &seen]() {
+            int value = 0;
+            for (int i = 0; i < producers * per_producer / consumers; ++i) {
+                queue.pop(value);
+                ++seen[value];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int wrong = 0;
+    for (const auto& count : seen) {
+        wrong += count != 1;
+    }
+    REQUIRE(wrong == 0);
+
+    int value = 0;
+    REQUIRE_FALSE(queue.tryPop(value));
+}
+
+TEST_CASE("PipelineRunner::MatchesBatchRunner", "[PipelineRunner]") {
+    std::vector<BatchScene> scenes;
+    for (int i = 0; i < 150; ++i) {
+        std::ostringstream json;
+        json << "{\"rects\": [";
+        for (int r = 0; r < 2 + i % 9; ++r) {
+            json << (r ? ", " : "") << "{\"x\": " << (r * 7 + i) % 23 << ", \"y\": " << (r * 5) % 17
+                 << ", \"w\": " << 4 + (r + i) % 11 << ", \"h\": " << (r == 3 && i % 13 == 0 ? 0 : 6) << "}";
+        }
+        json << "]}";
+        scenes.push_back({"line " + std::to_string(i + 1), json.str()});
+    }
+    scenes[40].json = "{\"rects\": [";
+    scenes[41].json = "{\"rects\": [{\"x\": 0, \"y\": 0, \"w\": 1, \"h\": 1}]}";
+    scenes.push_back({"missing_pipeline_scene.json", std::string()});
+
+    for (const char* mode : {"", "--maximal", "--cells", "--area"}) {
+        BatchOptions options;
+        options.mode = mode;
+
+        ThreadPool pool(2);
+        std::ostringstream expected;
+        size_t expected_failures = BatchRunner::run(scenes, options, pool, expected);
+
+        for (size_t workers : {1, 4}) {
+            std::ostringstream piped;
+            REQUIRE(PipelineRunner::run(scenes, options, workers, piped) == expected_failures);
+            REQUIRE(piped.str() == expected.str());
+        }
+    }
+}
+
+TEST_CASE("PipelineRunner::SlowHeadSceneKeepsReorderWindow", "[PipelineRunner]") {
+    /* The first scene takes far longer than the rest, so the other worker races ahead of the writer */
+    std::ostringstream head;
+    head << "{\"rects\": [";
+    for (int r = 0; r < 600; ++r) {
+        head << (r ? ", " : "") << "{\"x\": " << r % 50 << ", \"y\": " << (r * 7) % 50 << ", \"w\": 100, \"h\": 100}";
+    }
+    head << "]}";
+
+    std::vector<BatchScene> scenes = {{"line 1", head.str()}};
+    for (int i = 1; i < 400; ++i) {
+        scenes.push_back({"line " + std::to_string(i + 1), "{\"rects\": [{\"x\": 0, \"y\": 0, \"w\": 5, \"h\": 5}, {\"x\": 2, \"y\": 2, \"w\": 5, \"h\": 5}]}"});
+    }
+
+    BatchOptions options;
+    options.mode = "--count-orders";
+
+    ThreadPool pool(2);
+    std::ostringstream expected;
+    REQUIRE(BatchRunner::run(scenes, options, pool, expected) == 0);
+
+    const size_t workers = 2;
+    size_t peak_pending = 0;
+    std::ostringstream piped;
+    REQUIRE(PipelineRunner::run(scenes, options, workers, piped, &peak_pending) == 0);
+    REQUIRE(piped.str() == expected.str());
+    REQUIRE(peak_pending >= 1);
+    REQUIRE(peak_pending <= PIPELINE_WINDOW_PER_WORKER * workers);
+}
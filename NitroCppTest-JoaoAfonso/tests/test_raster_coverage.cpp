@@ -0,0 +1,87 @@
+#define private public // For testing purposes, make private members public
+#include "../IntersectionFinder.h"
+#undef private // Restore private access after testing
+#include "../RasterCoverage.h"
+#include "../DepthQuery.h"
+#include "../AreaCalculator.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+#include "test_helpers.h"
+
+TEST_CASE("RasterCoverage::DepthAtCountsCoveringRectangles", "[RasterCoverage]") {
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10)};
+    RasterCoverage raster(rects);
+    CHECK(raster.depthAt(0, 0) == 1);
+    CHECK(raster.depthAt(5, 5) == 2);
+    CHECK(raster.depthAt(9, 9) == 2);
+    CHECK(raster.depthAt(10, 10) == 1);
+    CHECK(raster.depthAt(14, 14) == 1);
+    CHECK(raster.depthAt(15, 15) == 0);
+    CHECK(raster.depthAt(-1, 3) == 0);
+    CHECK(raster.depthAt(12, 2) == 0);
+}
+
+TEST_CASE("RasterCoverage::SuitabilityDependsOnBoundingBox", "[RasterCoverage]") {
+    std::vector<Rectangle> small = {Rectangle(1, 0, 0, 4, 4), Rectangle(2, 2, 2, 4, 4)};
+    std::vector<Rectangle> sparse = {Rectangle(1, 0, 0, 4, 4), Rectangle(2, 5000, 5000, 4, 4)};
+    std::vector<Rectangle> huge = {Rectangle(1, -2000000000, 0, 4, 4), Rectangle(2, 2000000000, 2000000000, 4, 4)};
+    CHECK(RasterCoverage::isSuitable(small));
+    CHECK_FALSE(RasterCoverage::isSuitable(sparse));
+    CHECK_FALSE(RasterCoverage::isSuitable(huge));
+    CHECK_FALSE(RasterCoverage::isSuitable({}));
+}
+
+TEST_CASE("RasterCoverage::MatchesSweepEngines", "[RasterCoverage]") {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> position(-30, 30);
+    std::uniform_int_distribution<int> size(1, 20);
+
+    for (int scene = 0; scene < 20; ++scene) {
+        std::vector<Rectangle> rects;
+        for (int id = 1; id <= 40; ++id) {
+            rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        }
+        RasterCoverage raster(rects);
+
+        auto raster_area = raster.computeAreaStats();
+        auto sweep_area = AreaCalculator::computeAreaStats(rects);
+        REQUIRE(raster_area.union_area == sweep_area.union_area);
+        REQUIRE(raster_area.area_by_depth == sweep_area.area_by_depth);
+
+        auto raster_depth = raster.findMaxDepth(rects);
+        auto sweep_depth = DepthQuery::findMaxDepth(rects);
+        REQUIRE(raster_depth.parent_ids.size() == sweep_depth.parent_ids.size());
+        REQUIRE(raster.depthAt(raster_depth.rect.x(), raster_depth.rect.y()) == static_cast<int>(raster_depth.parent_ids.size()));
+    }
+}
+
+TEST_CASE("IntersectionFinder::ChoosesRasterForSmallCanvas", "[IntersectionFinder]") {
+    std::string filename = writeTempJson(R"({
+        "rects": [
+            {"x": 0, "y": 0, "w": 10, "h": 10},
+            {"x": 5, "y": 5, "w": 10, "h": 10}
+        ]
+    })");
+    IntersectionFinder finder;
+    finder.loadRectanglesFromFile(filename);
+    REQUIRE(finder.raster() == nullptr); // 225 cells for 2 rectangles: sweeping is cheaper
+    REQUIRE(finder.depthAt(6, 6) == 2);
+    REQUIRE(finder.findMaxDepth().parent_ids == std::pmr::vector<int>({1, 2}));
+    removeTempFile(filename);
+
+    std::string json = R"({"rects":[)";
+    for (int i = 0; i < 8; ++i) {
+        json += "{\"x\":" + std::to_string(i) + ",\"y\":0,\"w\":2,\"h\":2}";
+        if (i != 7) json += ",";
+    }
+    json += "]}";
+    filename = writeTempJson(json);
+    IntersectionFinder dense;
+    dense.loadRectanglesFromFile(filename);
+    REQUIRE(dense.raster() != nullptr);
+    REQUIRE(dense.depthAt(3, 1) == 2);
+    REQUIRE(dense.computeAreaStats().union_area == 18);
+    removeTempFile(filename);
+}
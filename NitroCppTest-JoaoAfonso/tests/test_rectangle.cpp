@@ -133,4 +133,18 @@ TEST_CASE("Rectangle::No intersection", "[rectangle]") {
     bool intersects = Rectangle::calculate_intersection(r1, r2, result);
 
     REQUIRE(intersects == false);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Rectangle::loadFromFile loads everything when the limit is disabled", "[RectangleLoadFromFile]") {
+    std::string json = R"({"rects":[)";
+    for (int i = 0; i < MAX_RECTANGLES + 5; ++i) {
+        json += "{\"x\":0,\"y\":0,\"w\":1,\"h\":1}";
+        if (i != MAX_RECTANGLES + 4) json += ",";
+    }
+    json += "]}\n";
+    std::string filename = writeTempJson(json);
+    auto rects = Rectangle::loadFromFile(filename, 0);
+    REQUIRE(rects.size() == MAX_RECTANGLES + 5);
+    CHECK(rects.back().id() == MAX_RECTANGLES + 5);
+    removeTempFile(filename);
+}
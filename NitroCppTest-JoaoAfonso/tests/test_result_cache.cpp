@@ -0,0 +1,131 @@
+#include "../ResultCache.h"
+#include "../IntersectionFinder.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+    std::vector<Rectangle> scene() {
+        return {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 5, 5, 10, 10), Rectangle(3, 8, 0, 4, 20), Rectangle(4, 100, 100, 5, 5)};
+    }
+
+    /* The same rectangles in another order and with other IDs */
+    std::vector<Rectangle> relabelled() {
+        return {Rectangle(40, 8, 0, 4, 20), Rectangle(10, 100, 100, 5, 5), Rectangle(30, 0, 0, 10, 10), Rectangle(20, 5, 5, 10, 10)};
+    }
+
+    std::vector<IntersectionResult> enumerate(const std::vector<Rectangle>& rects) {
+        IntersectionFinder finder;
+        finder.loadRectangles(std::vector<Rectangle>(rects));
+        finder.processIntersections();
+        return finder.intersections();
+    }
+}
+
+TEST_CASE("ResultCache::HashIgnoresOrderAndIds", "[ResultCache]") {
+    REQUIRE(ResultCache::hashScene("", scene()) == ResultCache::hashScene("", relabelled()));
+    REQUIRE(ResultCache::hashScene("", scene()) != ResultCache::hashScene("--maximal", scene()));
+
+    auto moved = scene();
+    moved[3] = Rectangle(4, 100, 101, 5, 5);
+    REQUIRE(ResultCache::hashScene("", scene()) != ResultCache::hashScene("", moved));
+}
+
+TEST_CASE("ResultCache::ReplaysWithCallerIds", "[ResultCache]") {
+    ResultCache cache("");
+    std::vector<IntersectionResult> results;
+
+    REQUIRE_FALSE(cache.lookup("", scene(), results));
+    cache.store("", scene(), enumerate(scene()));
+
+    REQUIRE(cache.lookup("", relabelled(), results));
+    auto expected = enumerate(relabelled());
+    REQUIRE(results.size() == expected.size());
+
+    /* Every expected group is replayed with the same region; replayed IDs come back sorted */
+    for (auto group : expected) {
+        std::sort(group.parent_ids.begin(), group.parent_ids.end());
+        bool found = false;
+        for (const auto& replayed : results) {
+            found = found || (replayed.parent_ids == group.parent_ids && replayed.rect.x() == group.rect.x() &&
+                              replayed.rect.y() == group.rect.y() && replayed.rect.w() == group.rect.w() &&
+                              replayed.rect.h() == group.rect.h());
+        }
+        REQUIRE(found);
+    }
+
+    REQUIRE_FALSE(cache.lookup("--maximal", scene(), results));
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 2);
+}
+
+TEST_CASE("ResultCache::EvictsLeastRecentlyUsed", "[ResultCache]") {
+    ResultCache cache("", 2);
+    std::vector<IntersectionResult> results;
+    std::vector<std::vector<Rectangle>> scenes;
+    for (int i = 0; i < 3; ++i) {
+        scenes.push_back({Rectangle(1, i, 0, 5, 5), Rectangle(2, 2, 2, 5, 5)});
+        cache.store("", scenes.back(), enumerate(scenes.back()));
+        if (i == 1) {
+            REQUIRE(cache.lookup("", scenes[0], results));
+        }
+    }
+
+    REQUIRE(cache.lookup("", scenes[0], results));
+    REQUIRE_FALSE(cache.lookup("", scenes[1], results));
+    REQUIRE(cache.lookup("", scenes[2], results));
+}
+
+TEST_CASE("ResultCache::PersistsOnDisk", "[ResultCache]") {
+    const std::string directory = "temp_result_cache";
+    std::filesystem::remove_all(directory);
+
+    {
+        ResultCache writer(directory);
+        writer.store("--maximal", scene(), enumerate(scene()));
+    }
+
+    ResultCache reader(directory);
+    std::vector<IntersectionResult> results;
+    REQUIRE(reader.lookup("--maximal", relabelled(), results));
+    REQUIRE(results.size() == enumerate(scene()).size());
+    REQUIRE_FALSE(reader.lookup("", relabelled(), results));
+
+    /* A damaged file is a miss, not an error */
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::filesystem::resize_file(entry.path(), 20);
+    }
+    ResultCache damaged(directory);
+    REQUIRE_FALSE(damaged.lookup("--maximal", scene(), results));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ResultCache::OutOfRangeIdIsMiss", "[ResultCache]") {
+    const std::string directory = "temp_result_cache_ids";
+    std::filesystem::remove_all(directory);
+
+    {
+        ResultCache writer(directory);
+        writer.store("", scene(), enumerate(scene()));
+    }
+
+    /* Point the first ID of the first result past the 4 rectangles: magic, mode, coordinates, count, region, size */
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::fstream file(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        const int32_t bad_id = 99;
+        file.seekp(8 + 4 + 4 + 4 * 16 + 4 + 4 * 4 + 4);
+        file.write(reinterpret_cast<const char*>(&bad_id), sizeof(bad_id));
+    }
+
+    ResultCache reader(directory);
+    std::vector<IntersectionResult> results;
+    REQUIRE_FALSE(reader.lookup("", scene(), results));
+    REQUIRE(results.empty());
+    REQUIRE(reader.hits() == 0);
+    REQUIRE(reader.misses() == 1);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,95 @@
+#include "../RunStats.h"
+#include "../IntersectionFinder.h"
+#include "../json.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+namespace {
+    /* Three mutually overlapping rectangles and one far away */
+    const char* kScene = R"({"rects": [
+        {"x": 0, "y": 0, "w": 10, "h": 10},
+        {"x": 5, "y": 5, "w": 10, "h": 10},
+        {"x": 8, "y": 8, "w": 10, "h": 10},
+        {"x": 100, "y": 100, "w": 5, "h": 5}
+    ]})";
+
+    /* Allocations stored here escape, so the compiler cannot elide them */
+    char* volatile g_escaped = nullptr;
+}
+
+TEST_CASE("RunStats::CountsEnumerationEvents", "[RunStats]") {
+    RunStats::reset();
+    RunStats::enable(true);
+
+    IntersectionFinder finder;
+    std::istringstream input(kScene);
+    std::ostringstream info;
+    finder.loadRectanglesFromStream(input, 10, info);
+    finder.processIntersections();
+    std::ostringstream out;
+    finder.printResults(out);
+    RunStats::enable(false);
+
+    /* Half the pairs overlap, so SubsetEngine<4> tests the 6 pairs, then the 5 larger subsets in its table */
+    REQUIRE(RunStats::total(StatsCounter::IntersectionTests) == 11);
+    REQUIRE(RunStats::total(StatsCounter::IntersectionHits) == 4);
+    REQUIRE(RunStats::depthCount(2) == 3);
+    REQUIRE(RunStats::depthCount(3) == 1);
+    REQUIRE(RunStats::depthCount(4) == 0);
+    REQUIRE(RunStats::total(StatsCounter::Allocations) > 0);
+    REQUIRE(RunStats::seconds(StatsPhase::Parse) > 0.0);
+    REQUIRE(RunStats::seconds(StatsPhase::Pairwise) > 0.0);
+    REQUIRE(RunStats::seconds(StatsPhase::Print) > 0.0);
+    REQUIRE(RunStats::seconds(StatsPhase::Maximal) == 0.0);
+}
+
+TEST_CASE("RunStats::CollectsNothingWhileDisabled", "[RunStats]") {
+    RunStats::reset();
+
+    IntersectionFinder finder;
+    std::istringstream input(kScene);
+    std::ostringstream info;
+    finder.loadRectanglesFromStream(input, 10, info);
+    finder.processIntersections();
+    g_escaped = new char[16];
+    delete[] g_escaped;
+
+    REQUIRE(RunStats::total(StatsCounter::IntersectionTests) == 0);
+    REQUIRE(RunStats::total(StatsCounter::Allocations) == 0);
+    REQUIRE(RunStats::seconds(StatsPhase::Parse) == 0.0);
+}
+
+TEST_CASE("RunStats::CountsAllocatedBytes", "[RunStats]") {
+    RunStats::reset();
+    RunStats::enable(true);
+    g_escaped = new char[1000];
+    RunStats::enable(false);
+    delete[] g_escaped;
+
+    REQUIRE(RunStats::total(StatsCounter::Allocations) == 1);
+    REQUIRE(RunStats::total(StatsCounter::AllocatedBytes) == 1000);
+}
+
+TEST_CASE("RunStats::WritesJsonReport", "[RunStats]") {
+    RunStats::reset();
+    RunStats::enable(true);
+    IntersectionFinder finder;
+    std::istringstream input(kScene);
+    std::ostringstream info;
+    finder.loadRectanglesFromStream(input, 10, info);
+    finder.processIntersections();
+    RunStats::enable(false);
+
+    std::ostringstream out;
+    RunStats::writeJson(out);
+    nlohmann::json report = nlohmann::json::parse(out.str());
+
+    REQUIRE(report["calculate_intersection"]["calls"] == 11);
+    REQUIRE(report["calculate_intersection"]["misses"] == 7);
+    REQUIRE(report["recursion_depth"]["3"] == 1);
+    REQUIRE_FALSE(report.contains("dedup"));
+    REQUIRE(report["phase_seconds"].contains("recursion"));
+    REQUIRE(report["allocations"]["bytes"].get<uint64_t>() > 0);
+    REQUIRE(report["wall_seconds"].get<double>() >= 0.0);
+}
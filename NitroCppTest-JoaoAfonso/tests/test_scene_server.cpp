@@ -0,0 +1,161 @@
+#include "../SceneServer.h"
+#include "../IntersectionFinder.h"
+#include "../IndexSnapshot.h"
+#include "test_helpers.h"
+#include <catch2/catch_test_macros.hpp>
+#include <climits>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+    const char* kSocketPath = "temp_scene_server.sock";
+    const char* kScene = R"({
+        "rects": [
+            {"x": 0, "y": 0, "w": 10, "h": 10},
+            {"x": 5, "y": 5, "w": 10, "h": 10},
+            {"x": 8, "y": 0, "w": 4, "h": 20},
+            {"x": 100, "y": 100, "w": 5, "h": 5}
+        ]
+    })";
+}
+
+TEST_CASE("SceneServer::AnswersQueriesOverSocket", "[SceneServer]") {
+    std::string filename = writeTempJson(kScene);
+    SceneServer server(kSocketPath);
+    std::thread serving([&server]() { server.run(); });
+
+    {
+        SceneClient client(kSocketPath);
+        client.ping();
+
+        uint32_t count = 0;
+        uint32_t scene = client.load(filename, count);
+        REQUIRE(count == 4);
+
+        REQUIRE(client.window(scene, Rectangle(-1, 9, 9, 2, 2)) == std::vector<int>{1, 2, 3});
+        REQUIRE(client.window(scene, Rectangle(-1, 50, 50, 10, 10)).empty());
+        REQUIRE(client.stab(scene, 102, 102) == std::vector<int>{4});
+        REQUIRE(client.stab(scene, 10, 0) == std::vector<int>{3});
+
+        IntersectionFinder local;
+        local.loadRectanglesFromFile(filename, 0);
+        local.processIntersections();
+
+        auto remote = client.intersections(scene);
+        REQUIRE(remote.size() == local.intersections().size());
+        for (size_t i = 0; i < remote.size(); ++i) {
+            REQUIRE(remote[i].parent_ids == local.intersections()[i].parent_ids);
+            REQUIRE(remote[i].rect.x() == local.intersections()[i].rect.x());
+            REQUIRE(remote[i].rect.w() == local.intersections()[i].rect.w());
+        }
+        /* The second request is served from the cached enumeration */
+        REQUIRE(client.intersections(scene).size() == remote.size());
+
+        /* Errors are reported without taking the server down */
+        REQUIRE_THROWS_AS(client.stab(scene + 1, 0, 0), std::runtime_error);
+        REQUIRE_THROWS_AS(client.window(scene, Rectangle(-1, 0, 0, 0, 5)), std::runtime_error);
+        REQUIRE_THROWS_AS(client.load("missing_scene.json", count), std::runtime_error);
+
+        client.unload(scene);
+        REQUIRE_THROWS_AS(client.stab(scene, 0, 0), std::runtime_error);
+
+        client.shutdown();
+    }
+
+    serving.join();
+    removeTempFile(filename);
+}
+
+TEST_CASE("SceneServer::ServesIndexSnapshots", "[SceneServer]") {
+    std::string filename = writeTempJson(kScene);
+    const std::string snapshot = "temp_scene_server.nrix";
+    IndexSnapshot::write(snapshot, Rectangle::loadFromFile(filename, 0));
+
+    SceneServer server(kSocketPath);
+    std::thread serving([&server]() { server.run(); });
+
+    {
+        SceneClient client(kSocketPath);
+        uint32_t json_count = 0;
+        uint32_t snapshot_count = 0;
+        uint32_t from_json = client.load(filename, json_count);
+        uint32_t from_snapshot = client.load(snapshot, snapshot_count);
+        REQUIRE(snapshot_count == json_count);
+
+        REQUIRE(client.window(from_snapshot, Rectangle(-1, 9, 9, 2, 2)) == client.window(from_json, Rectangle(-1, 9, 9, 2, 2)));
+        REQUIRE(client.stab(from_snapshot, 102, 102) == std::vector<int>{4});
+        REQUIRE(client.intersections(from_snapshot).size() == client.intersections(from_json).size());
+
+        /* Windows and points reaching past INT_MAX are refused by both kinds of scene alike */
+        for (uint32_t scene : {from_json, from_snapshot}) {
+            REQUIRE_THROWS_AS(client.window(scene, Rectangle(-1, INT_MAX, INT_MAX, INT_MAX, INT_MAX)), std::runtime_error);
+            REQUIRE_THROWS_AS(client.window(scene, Rectangle(-1, 0, INT_MAX - 4, 10, 10)), std::runtime_error);
+            REQUIRE_THROWS_AS(client.stab(scene, INT_MAX, 0), std::runtime_error);
+            REQUIRE_THROWS_AS(client.stab(scene, 0, INT_MAX), std::runtime_error);
+        }
+        REQUIRE(client.window(from_snapshot, Rectangle(-1, 100, 100, INT_MAX - 100, INT_MAX - 100)) ==
+                client.window(from_json, Rectangle(-1, 100, 100, INT_MAX - 100, INT_MAX - 100)));
+        REQUIRE(client.window(from_json, Rectangle(-1, 100, 100, INT_MAX - 100, INT_MAX - 100)) == std::vector<int>{4});
+        REQUIRE(client.stab(from_snapshot, INT_MAX - 1, 0) == client.stab(from_json, INT_MAX - 1, 0));
+
+        client.shutdown();
+    }
+
+    serving.join();
+    std::remove(snapshot.c_str());
+    removeTempFile(filename);
+}
+
+TEST_CASE("SceneServer::PartialFrameDoesNotStallOtherClients", "[SceneServer]") {
+    std::string filename = writeTempJson(kScene);
+    SceneServer server(kSocketPath);
+    std::thread serving([&server]() { server.run(); });
+
+    /* A raw client sends half a header, then the start of a Load payload, and stops */
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, kSocketPath);
+    int stalled = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(connect(stalled, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    const uint8_t partial[] = {static_cast<uint8_t>(ServerOpcode::Load), 100, 0};
+    REQUIRE(send(stalled, partial, sizeof(partial), 0) == sizeof(partial));
+
+    {
+        SceneClient client(kSocketPath);
+        client.ping();
+        uint32_t count = 0;
+        uint32_t scene = client.load(filename, count);
+        REQUIRE(count == 4);
+
+        /* The rest of the header arrives, the payload still does not */
+        const uint8_t rest[] = {0, 0, 't', 'e'};
+        REQUIRE(send(stalled, rest, sizeof(rest), 0) == sizeof(rest));
+        REQUIRE(client.stab(scene, 102, 102) == std::vector<int>{4});
+
+        /* Once the frame completes, the stalled client gets its answer too */
+        std::string tail(98, 'x');
+        REQUIRE(send(stalled, tail.data(), tail.size(), 0) == static_cast<ssize_t>(tail.size()));
+        uint8_t status = 0;
+        std::vector<uint8_t> response;
+        REQUIRE(readFrame(stalled, status, response));
+        REQUIRE(status == static_cast<uint8_t>(ServerStatus::Error));
+
+        client.shutdown();
+    }
+
+    serving.join();
+    close(stalled);
+    removeTempFile(filename);
+}
+
+TEST_CASE("SceneServer::RejectsInvalidSocketPath", "[SceneServer]") {
+    REQUIRE_THROWS_AS(SceneServer(""), std::runtime_error);
+    REQUIRE_THROWS_AS(SceneClient("temp_no_such_server.sock"), std::runtime_error);
+}
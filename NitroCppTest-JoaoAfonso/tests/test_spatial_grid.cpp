@@ -0,0 +1,68 @@
+#include "../SpatialGrid.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <random>
+
+namespace {
+    std::vector<int> bruteForceQuery(const std::vector<Rectangle>& rects, const Rectangle& window) {
+        std::vector<int> ids;
+        Rectangle overlap(-1, 0, 0, 0, 0);
+        for (const auto& r : rects) {
+            if (Rectangle::calculate_intersection(r, window, overlap)) {
+                ids.push_back(r.id());
+            }
+        }
+        return ids;
+    }
+}
+
+TEST_CASE("SpatialGrid::RejectsNonPositiveCellSize", "[SpatialGrid]") {
+    REQUIRE_THROWS_AS(SpatialGrid(0), std::invalid_argument);
+}
+
+TEST_CASE("SpatialGrid::InsertQueryErase", "[SpatialGrid]") {
+    SpatialGrid grid(10);
+    grid.insert(Rectangle(1, -15, -15, 10, 10));
+    grid.insert(Rectangle(2, -8, -8, 20, 20));
+    grid.insert(Rectangle(3, 100, 100, 5, 5));
+    REQUIRE(grid.size() == 3);
+
+    CHECK(grid.query(Rectangle(-1, -7, -7, 1, 1)) == std::vector<int>({1, 2}));
+    CHECK(grid.query(Rectangle(-1, 0, 0, 200, 200)) == std::vector<int>({2, 3}));
+    CHECK(grid.query(Rectangle(-1, 12, 0, 5, 5)).empty()); // touches rectangle 2's right edge only
+
+    REQUIRE(grid.erase(2));
+    REQUIRE_FALSE(grid.erase(2));
+    CHECK(grid.query(Rectangle(-1, -7, -7, 1, 1)) == std::vector<int>({1}));
+    CHECK(grid.find(2) == nullptr);
+    REQUIRE(grid.find(3) != nullptr);
+    CHECK(grid.find(3)->x() == 100);
+}
+
+TEST_CASE("SpatialGrid::HandlesOversizedRectangles", "[SpatialGrid]") {
+    SpatialGrid grid(4);
+    grid.insert(Rectangle(1, -1000000000, -1000000000, 2000000000, 2000000000));
+    grid.insert(Rectangle(2, 0, 0, 3, 3));
+    CHECK(grid.query(Rectangle(-1, 1, 1, 1, 1)) == std::vector<int>({1, 2}));
+    REQUIRE(grid.erase(1));
+    CHECK(grid.query(Rectangle(-1, 1, 1, 1, 1)) == std::vector<int>({2}));
+}
+
+TEST_CASE("SpatialGrid::MatchesBruteForceOnRandomScenes", "[SpatialGrid]") {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> position(-500, 500);
+    std::uniform_int_distribution<int> size(1, 120);
+
+    SpatialGrid grid(32);
+    std::vector<Rectangle> rects;
+    for (int id = 1; id <= 300; ++id) {
+        rects.emplace_back(id, position(rng), position(rng), size(rng), size(rng));
+        grid.insert(rects.back());
+    }
+
+    for (int query = 0; query < 100; ++query) {
+        Rectangle window(-1, position(rng), position(rng), size(rng), size(rng));
+        REQUIRE(grid.query(window) == bruteForceQuery(rects, window));
+    }
+}
@@ -0,0 +1,112 @@
+#include "../Rectangle.h"
+#include "../RunStats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include <random>
+#define private public // For testing purposes, reach both enumeration strategies
+#include "../SubsetEngine.h"
+#undef private // Restore private access after testing
+
+namespace {
+    struct Group {
+        std::vector<int> ids;
+        Rectangle region;
+    };
+
+    /* Every subset of 2 or more rectangles with a common region, in ascending-sequence order */
+    void bruteForce(const std::vector<Rectangle>& rects, size_t start, const Rectangle& region,
+                    std::vector<int>& ids, std::vector<Group>& groups) {
+        for (size_t i = start; i < rects.size(); ++i) {
+            Rectangle next = rects[i];
+            if (!ids.empty() && !Rectangle::calculate_intersection(region, rects[i], next)) {
+                continue;
+            }
+            ids.push_back(rects[i].id());
+            if (ids.size() > 1) {
+                groups.push_back({ids, next});
+            }
+            bruteForce(rects, i + 1, next, ids, groups);
+            ids.pop_back();
+        }
+    }
+
+    template <typename Enumerate>
+    std::vector<Group> collect(Enumerate enumerate) {
+        std::vector<Group> groups;
+        size_t found = enumerate([&groups](const Rectangle& region, const int* ids, size_t count) {
+            groups.push_back({std::vector<int>(ids, ids + count), region});
+        });
+        REQUIRE(found == groups.size());
+        return groups;
+    }
+
+    void requireSame(const std::vector<Group>& got, const std::vector<Group>& want) {
+        REQUIRE(got.size() == want.size());
+        for (size_t k = 0; k < want.size(); ++k) {
+            REQUIRE(got[k].ids == want[k].ids);
+            REQUIRE(got[k].region.x() == want[k].region.x());
+            REQUIRE(got[k].region.y() == want[k].region.y());
+            REQUIRE(got[k].region.w() == want[k].region.w());
+            REQUIRE(got[k].region.h() == want[k].region.h());
+        }
+    }
+
+    template <size_t N>
+    void checkScenes(std::mt19937& rng) {
+        for (int spread : {10, 50, 300}) {
+            std::uniform_int_distribution<int> position(0, spread);
+            std::uniform_int_distribution<int> side(1, 40);
+            std::vector<Rectangle> rects;
+            for (size_t i = 0; i < N; ++i) {
+                rects.emplace_back(static_cast<int>(i) + 1, position(rng), position(rng), side(rng), side(rng));
+            }
+
+            std::vector<Group> expected;
+            std::vector<int> ids;
+            bruteForce(rects, 0, Rectangle(-1, 0, 0, 0, 0), ids, expected);
+
+            requireSame(collect([&](auto&& record) { return SubsetEngine<N>::enumerate(rects.data(), record); }), expected);
+            requireSame(collect([&](auto&& record) { return SubsetEngine<N>::enumerateTable(rects.data(), record); }), expected);
+
+            size_t overlaps[N] = {};
+            for (size_t i = 0; i < N; ++i) {
+                for (size_t j = 0; j < N; ++j) {
+                    Rectangle region(-1, 0, 0, 0, 0);
+                    if (i != j && Rectangle::calculate_intersection(rects[i], rects[j], region)) {
+                        overlaps[i] |= size_t(1) << j;
+                    }
+                }
+            }
+            requireSame(collect([&](auto&& record) { return SubsetEngine<N>::enumerateSparse(rects.data(), overlaps, record); }), expected);
+        }
+    }
+}
+
+TEST_CASE("SubsetEngine::MatchesBruteForceForEverySize", "[SubsetEngine]") {
+    std::mt19937 rng(5);
+    for (int round = 0; round < 10; ++round) {
+        checkScenes<2>(rng);
+        checkScenes<3>(rng);
+        checkScenes<4>(rng);
+        checkScenes<5>(rng);
+        checkScenes<6>(rng);
+        checkScenes<7>(rng);
+        checkScenes<8>(rng);
+        checkScenes<9>(rng);
+        checkScenes<10>(rng);
+    }
+}
+
+TEST_CASE("SubsetEngine::TouchingEdgesDoNotIntersect", "[SubsetEngine]") {
+    /* 1 and 2 share an edge, 3 covers both */
+    std::vector<Rectangle> rects = {Rectangle(1, 0, 0, 10, 10), Rectangle(2, 10, 0, 10, 10), Rectangle(3, 5, 5, 10, 10)};
+    auto groups = collect([&](auto&& record) { return SubsetEngine<3>::enumerate(rects.data(), record); });
+
+    REQUIRE(groups.size() == 2);
+    REQUIRE(groups[0].ids == std::vector<int>{1, 3});
+    REQUIRE(groups[1].ids == std::vector<int>{2, 3});
+    REQUIRE(groups[1].region.x() == 10);
+    REQUIRE(groups[1].region.w() == 5);
+}
@@ -0,0 +1,118 @@
+#include "../TraceRecorder.h"
+#include "../IntersectionFinder.h"
+#include "../BatchRunner.h"
+#include "../ThreadPool.h"
+#include "../json.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace {
+    nlohmann::json writeTrace() {
+        std::ostringstream out;
+        TraceRecorder::writeJson(out);
+        return nlohmann::json::parse(out.str());
+    }
+
+    /* Counts complete spans by name */
+    std::map<std::string, int> spanNames(const nlohmann::json& trace) {
+        std::map<std::string, int> names;
+        for (const auto& event : trace["traceEvents"]) {
+            if (event["ph"] == "X") {
+                ++names[event["name"].get<std::string>()];
+            }
+        }
+        return names;
+    }
+}
+
+TEST_CASE("TraceRecorder::RecordsFinderSpans", "[TraceRecorder]") {
+    TraceRecorder::reset();
+    TraceRecorder::enable(true);
+
+    IntersectionFinder finder;
+    std::istringstream input(R"({"rects": [{"x": 0, "y": 0, "w": 10, "h": 10}, {"x": 5, "y": 5, "w": 10, "h": 10}]})");
+    std::ostringstream info;
+    finder.loadRectanglesFromStream(input, 10, info);
+    finder.processIntersections();
+    finder.buildIndex();
+    std::ostringstream out;
+    finder.printResults(out);
+    TraceRecorder::enable(false);
+
+    nlohmann::json trace = writeTrace();
+    auto names = spanNames(trace);
+    REQUIRE(names["load"] == 1);
+    REQUIRE(names["enumerate"] == 1);
+    REQUIRE(names["index build"] == 1);
+    REQUIRE(names["output"] == 1);
+
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X") {
+            REQUIRE(event["ts"].get<double>() >= 0.0);
+            REQUIRE(event["dur"].get<double>() >= 0.0);
+        }
+    }
+}
+
+TEST_CASE("TraceRecorder::RecordsNothingWhileDisabled", "[TraceRecorder]") {
+    TraceRecorder::reset();
+    {
+        TRACE_SCOPE("ignored");
+    }
+    REQUIRE(TraceRecorder::spanCount() == 0);
+}
+
+TEST_CASE("TraceRecorder::SeparatesThreads", "[TraceRecorder]") {
+    std::vector<BatchScene> scenes;
+    for (int i = 0; i < 32; ++i) {
+        scenes.push_back({"scene" + std::to_string(i), R"({"rects": [{"x": 0, "y": 0, "w": 4, "h": 4}, {"x": 2, "y": 2, "w": 4, "h": 4}]})"});
+    }
+
+    TraceRecorder::reset();
+    TraceRecorder::enable(true);
+    {
+        ThreadPool pool(4);
+        std::ostringstream out;
+        BatchOptions options;
+        REQUIRE(BatchRunner::run(scenes, options, pool, out) == 0);
+    }
+    TraceRecorder::enable(false);
+
+    nlohmann::json trace = writeTrace();
+    REQUIRE(spanNames(trace)["scene"] == 32);
+    REQUIRE(spanNames(trace)["merge"] == 32);
+
+    /* Every span runs on a worker named in the metadata */
+    std::set<int> named;
+    std::set<int> used;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M" && event["args"]["name"].get<std::string>().rfind("worker ", 0) == 0) {
+            named.insert(event["tid"].get<int>());
+        }
+        if (event["ph"] == "X" && event["name"] == "scene") {
+            used.insert(event["tid"].get<int>());
+        }
+    }
+    REQUIRE(!used.empty());
+    for (int tid : used) {
+        REQUIRE(named.count(tid) == 1);
+    }
+}
+
+TEST_CASE("TraceRecorder::RingKeepsNewestSpans", "[TraceRecorder]") {
+    TraceRecorder::reset();
+    TraceRecorder::enable(true);
+    uint64_t start = TraceRecorder::now();
+    for (uint64_t i = 0; i < TRACE_RING_CAPACITY + 100; ++i) {
+        TraceRecorder::record(i < 100 ? "old" : "new", start + i, 1);
+    }
+    TraceRecorder::enable(false);
+
+    REQUIRE(TraceRecorder::spanCount() == TRACE_RING_CAPACITY);
+    auto names = spanNames(writeTrace());
+    REQUIRE(names.count("old") == 0);
+    REQUIRE(names["new"] == static_cast<int>(TRACE_RING_CAPACITY));
+}
@@ -0,0 +1,124 @@
+#include "../WorkloadGenerator.h"
+#include "../OverlapCounter.h"
+#include "../Rectangle.h"
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include <tuple>
+#include <sstream>
+#include <stdexcept>
+
+TEST_CASE("WorkloadGenerator::EveryWorkloadIsValidAndReproducible", "[WorkloadGenerator]") {
+    for (Workload kind : WorkloadGenerator::all()) {
+        WorkloadParams params;
+        params.kind = kind;
+        params.count = 500;
+        params.seed = 9;
+
+        auto first = WorkloadGenerator::generate(params);
+        auto second = WorkloadGenerator::generate(params);
+        REQUIRE(first.size() == params.count);
+
+        for (size_t i = 0; i < first.size(); ++i) {
+            REQUIRE(first[i].id() == static_cast<int>(i + 1));
+            REQUIRE(first[i].w() > 0);
+            REQUIRE(first[i].h() > 0);
+            REQUIRE(first[i].x() == second[i].x());
+            REQUIRE(first[i].h() == second[i].h());
+        }
+
+        Workload parsed;
+        REQUIRE(WorkloadGenerator::parse(WorkloadGenerator::name(kind), parsed));
+        REQUIRE(parsed == kind);
+    }
+
+    Workload parsed;
+    REQUIRE_FALSE(WorkloadGenerator::parse("spiral", parsed));
+}
+
+TEST_CASE("WorkloadGenerator::ShapesHaveTheirDefiningProperty", "[WorkloadGenerator]") {
+    WorkloadParams params;
+    params.count = 200;
+
+    params.kind = Workload::AllOverlap;
+    auto all = WorkloadGenerator::generate(params);
+    REQUIRE(OverlapCounter::countOverlappingPairs(all) == 200u * 199u / 2u);
+
+    params.kind = Workload::Duplicates;
+    std::set<std::tuple<int, int, int, int>> distinct;
+    for (const auto& r : WorkloadGenerator::generate(params)) {
+        distinct.insert(std::make_tuple(r.x(), r.y(), r.w(), r.h()));
+    }
+    REQUIRE(distinct.size() <= 20);
+
+    /* Each doll lies strictly inside the previous one of its stack */
+    params.kind = Workload::Nested;
+    auto dolls = WorkloadGenerator::generate(params);
+    for (size_t i = 1; i < dolls.size(); ++i) {
+        if (i % 8 != 0) {
+            REQUIRE(dolls[i].x() > dolls[i - 1].x());
+            REQUIRE(dolls[i].right() < dolls[i - 1].right());
+            REQUIRE(dolls[i].bottom() < dolls[i - 1].bottom());
+        }
+    }
+
+    params.kind = Workload::Grid;
+    for (const auto& r : WorkloadGenerator::generate(params)) {
+        REQUIRE(r.x() % params.mean_size == 0);
+        REQUIRE(r.w() % params.mean_size == 0);
+    }
+
+    params.mean_size = 0;
+    REQUIRE_THROWS_AS(WorkloadGenerator::generate(params), std::invalid_argument);
+}
+
+TEST_CASE("WorkloadGenerator::JsonRoundTrip", "[WorkloadGenerator]") {
+    WorkloadParams params;
+    params.kind = Workload::Clustered;
+    params.count = 300;
+    auto rects = WorkloadGenerator::generate(params);
+
+    std::stringstream json;
+    WorkloadGenerator::writeJson(json, rects);
+    std::ostringstream info;
+    auto loaded = Rectangle::loadFromStream(json, 0, info);
+
+    REQUIRE(info.str().empty());
+    REQUIRE(loaded.size() == rects.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        REQUIRE(loaded[i].id() == rects[i].id());
+        REQUIRE(loaded[i].x() == rects[i].x());
+        REQUIRE(loaded[i].y() == rects[i].y());
+        REQUIRE(loaded[i].w() == rects[i].w());
+        REQUIRE(loaded[i].h() == rects[i].h());
+    }
+
+    std::stringstream empty;
+    WorkloadGenerator::writeJson(empty, {});
+    REQUIRE(Rectangle::loadFromStream(empty, 0, info).empty());
+}
+
+TEST_CASE("WorkloadGenerator::StreamedJsonMatchesGeneratedScene", "[WorkloadGenerator]") {
+    for (Workload kind : WorkloadGenerator::all()) {
+        WorkloadParams params;
+        params.kind = kind;
+        params.count = 250;
+
+        std::stringstream stored;
+        std::stringstream streamed;
+        WorkloadGenerator::writeJson(stored, WorkloadGenerator::generate(params));
+        WorkloadGenerator::streamJson(streamed, params);
+        REQUIRE(streamed.str() == stored.str());
+    }
+}
+
+TEST_CASE("WorkloadGenerator::DensityForPairsHitsTarget", "[WorkloadGenerator]") {
+    WorkloadParams params;
+    params.count = 4000;
+
+    for (uint64_t target : {1000u, 20000u}) {
+        params.density = WorkloadGenerator::densityForPairs(params, target);
+        uint64_t pairs = OverlapCounter::countOverlappingPairs(WorkloadGenerator::generate(params));
+        REQUIRE(pairs >= target * 9 / 10);
+        REQUIRE(pairs <= target * 11 / 10);
+    }
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "IndexSnapshot.h"
+#include "WorkloadGenerator.h"
+
+/**
+ * @brief Entry point of the scene generator.
+ *
+ * Writes a synthetic scene as JSON (the schema read by Rectangle::loadFromFile) or as an index snapshot
+ * (the --write-index format served by --serve). Options:
+ * - --workload <name>: shape of the scene, as in WorkloadGenerator::name() (default uniform).
+ * - --count <n>: number of rectangles (default 1000).
+ * - --seed <n>: generator seed (default 1); the same options always give the same scene.
+ * - --size <n>: typical side length (default 100).
+ * - --density <d>: mean number of rectangles covering a point (default 1).
+ * - --target-pairs <n>: choose the density that gives about n overlapping pairs instead.
+ * - --format <json | index>: output format (default json).
+ * - --output <file>: destination (default: stdout for JSON; required for index).
+ * JSON is generated and written in a single streaming pass, so scenes larger than memory can be produced.
+ */
+int main(int argc, char* argv[]) 
+{
+    WorkloadParams params;
+    std::string format = "json";
+    std::string output;
+    std::string target_pairs;
+
+    try 
+    {
+        for (int i = 1; i < argc; ++i) 
+        {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+
+            if (arg == "--workload" && has_value) 
+            {
+                if (!WorkloadGenerator::parse(argv[++i], params.kind)) 
+                {
+                    throw std::invalid_argument(std::string("Unknown workload: ") + argv[i]);
+                }
+            }
+            else if (arg == "--count" && has_value) 
+            {
+                params.count = std::stoull(argv[++i]);
+            }
+            else if (arg == "--seed" && has_value) 
+            {
+                params.seed = std::stoull(argv[++i]);
+            }
+            else if (arg == "--size" && has_value) 
+            {
+                params.mean_size = std::stoi(argv[++i]);
+            }
+            else if (arg == "--density" && has_value) 
+            {
+                params.density = std::stod(argv[++i]);
+            }
+            else if (arg == "--target-pairs" && has_value) 
+            {
+                target_pairs = argv[++i];
+            }
+            else if (arg == "--format" && has_value && (std::string(argv[i + 1]) == "json" || std::string(argv[i + 1]) == "index")) 
+            {
+                format = argv[++i];
+            }
+            else if (arg == "--output" && has_value) 
+            {
+                output = argv[++i];
+            }
+            else 
+            {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+
+        if (format == "index" && output.empty()) 
+        {
+            throw std::invalid_argument("--format index needs --output.");
+        }
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        std::cerr << "Usage: " << argv[0] << " [--workload <name>] [--count <n>] [--seed <n>] [--size <n>]"
+                  << " [--density <d> | --target-pairs <n>] [--format json | index] [--output <file>]\n";
+        return 1;
+    }
+
+    try 
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        if (!target_pairs.empty()) 
+        {
+            params.density = WorkloadGenerator::densityForPairs(params, std::stoull(target_pairs));
+            std::cerr << "Density " << params.density << " for about " << target_pairs << " overlapping pairs.\n";
+        }
+
+        if (format == "index") 
+        {
+            IndexSnapshot::write(output, WorkloadGenerator::generate(params));
+        }
+        else if (output.empty()) 
+        {
+            WorkloadGenerator::streamJson(std::cout, params);
+            std::cout.flush();
+        }
+        else 
+        {
+            std::ofstream file(output, std::ios::binary);
+            if (!file.is_open()) 
+            {
+                throw std::runtime_error("Could not open file: " + output);
+            }
+            WorkloadGenerator::streamJson(file, params);
+            file.close();
+            if (!file) 
+            {
+                throw std::runtime_error("Could not write file: " + output);
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Generated " << params.count << " " << WorkloadGenerator::name(params.kind) << " rectangles in "
+                  << seconds << " s.\n";
+    } 
+    catch (const std::exception& e) 
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}